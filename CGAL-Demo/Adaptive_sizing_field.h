@@ -0,0 +1,225 @@
+#ifndef LAR_ADAPTIVE_SIZING_FIELD_H
+#define LAR_ADAPTIVE_SIZING_FIELD_H
+
+#include "Parallel.h"
+
+#include <CGAL/Kernel_traits.h>
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/boost/graph/iterator.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// 自适应尺寸场参数
+struct Adaptive_sizing_options {
+    // 边长上下限：平坦区域取上限，高曲率区域不小于下限
+    double min_size = 0.0;
+    double max_size = 0.0;
+    // 弦高误差：曲率为 k 处边长 h 满足 h^2 k / 8 <= facet_distance
+    double facet_distance = 0.0;
+    // 特征边附近的边长，0 表示取 min_size
+    double feature_size = 0.0;
+    // 边长随距离增长的最大斜率，保证相邻单元尺寸平滑过渡
+    double grading = 0.5;
+    // 查找网格的格子数上限
+    std::size_t max_cells = std::size_t(1) << 18;
+    // 线程数，0 表示使用全部硬件线程
+    unsigned num_threads = 0;
+};
+
+// 按顶点曲率与特征边距离自适应的尺寸场，满足 Mesh_3 的 MeshDomainField_3 概念，
+// 可直接传给 surface_Delaunay_remeshing 的 mesh_edge_size 与 mesh_facet_size
+// 构造时：
+// 1. 并行计算面积加权的顶点法向，曲率取法向对相邻顶点的最大变化率，换算成满足弦高误差的边长
+// 2. 把顶点边长与特征边采样点写入覆盖包围盒的均匀网格，每格取最小值
+// 3. 沿三个轴各做一次正反向扫描（各行并行），使相邻格子的差不超过 grading × 格子边长
+// 查询时只按坐标定位格子，O(1) 且不访问网格
+template <typename Kernel>
+class Adaptive_sizing_field {
+public:
+    typedef typename Kernel::FT FT;
+    typedef typename Kernel::Point_3 Point_3;
+    typedef int Index;
+
+    template <typename Point, typename EdgeIsFeatureMap>
+    Adaptive_sizing_field(const CGAL::Surface_mesh<Point>& mesh, EdgeIsFeatureMap eif,
+                          const Adaptive_sizing_options& options) {
+        build(mesh, eif, options);
+    }
+
+    FT operator()(const Point_3& p, const int = 3, const Index& = Index()) const {
+        std::size_t cell = 0;
+        for (int c = 2; c >= 0; --c) {
+            const double x = (CGAL::to_double(p[c]) - origin_[c]) * inv_cell_;
+            const int i = x <= 0.0 ? 0 : std::min(dims_[c] - 1, static_cast<int>(x));
+            cell = cell * static_cast<std::size_t>(dims_[c]) + static_cast<std::size_t>(i);
+        }
+        return FT(size_[cell]);
+    }
+
+    std::size_t number_of_cells() const { return size_.size(); }
+
+private:
+    template <typename Point, typename EdgeIsFeatureMap>
+    void build(const CGAL::Surface_mesh<Point>& mesh, EdgeIsFeatureMap eif, const Adaptive_sizing_options& options) {
+        typedef CGAL::Surface_mesh<Point> Mesh;
+        typedef typename Mesh::Vertex_index Vertex_index;
+        typedef typename Mesh::Face_index Face_index;
+        typedef std::array<double, 3> Vec;
+
+        const double max_size = options.max_size;
+        const double min_size = std::min(options.min_size, max_size);
+        const double feature_size = options.feature_size > 0 ? options.feature_size : min_size;
+        auto position = [&](Vertex_index v) {
+            const Point& p = mesh.point(v);
+            return Vec{{CGAL::to_double(p.x()), CGAL::to_double(p.y()), CGAL::to_double(p.z())}};
+        };
+
+        // 网格：格子边长取最长边 / 每轴格子数，格子总数不超过 max_cells
+        Vec lo = {{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::max()}};
+        Vec hi = {{-lo[0], -lo[1], -lo[2]}};
+        for (Vertex_index v : mesh.vertices()) {
+            const Vec p = position(v);
+            for (int c = 0; c < 3; ++c) {
+                lo[c] = std::min(lo[c], p[c]);
+                hi[c] = std::max(hi[c], p[c]);
+            }
+        }
+        if (mesh.is_empty()) {
+            lo = hi = Vec{{0.0, 0.0, 0.0}};
+        }
+        const int per_axis = std::max(1, static_cast<int>(std::cbrt(static_cast<double>(options.max_cells))));
+        const double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2], 1e-12});
+        const double cell = extent / per_axis;
+        inv_cell_ = 1.0 / cell;
+        origin_ = lo;
+        for (int c = 0; c < 3; ++c) {
+            dims_[c] = std::max(1, std::min(per_axis, static_cast<int>(std::ceil((hi[c] - lo[c]) * inv_cell_))));
+        }
+        size_.assign(static_cast<std::size_t>(dims_[0]) * dims_[1] * dims_[2], max_size);
+        auto cell_of = [&](const Vec& p) {
+            std::size_t index = 0;
+            for (int c = 2; c >= 0; --c) {
+                const double x = (p[c] - origin_[c]) * inv_cell_;
+                const int i = x <= 0.0 ? 0 : std::min(dims_[c] - 1, static_cast<int>(x));
+                index = index * static_cast<std::size_t>(dims_[c]) + static_cast<std::size_t>(i);
+            }
+            return index;
+        };
+
+        // 1. 顶点法向与曲率换算的边长
+        const std::size_t nv = mesh.num_vertices();
+        std::vector<Vec> normal(nv, Vec{{0.0, 0.0, 0.0}});
+        parallel_for(nv, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t i = b; i < e; ++i) {
+                const Vertex_index v(static_cast<typename Mesh::size_type>(i));
+                if (mesh.is_removed(v) || mesh.is_isolated(v)) {
+                    continue;
+                }
+                Vec n = {{0.0, 0.0, 0.0}};
+                for (Face_index f : CGAL::faces_around_target(mesh.halfedge(v), mesh)) {
+                    if (f == Mesh::null_face()) {
+                        continue;
+                    }
+                    const auto h = mesh.halfedge(f);
+                    const Vec p = position(mesh.source(h)), q = position(mesh.target(h)),
+                              r = position(mesh.target(mesh.next(h)));
+                    const Vec u = {{q[0] - p[0], q[1] - p[1], q[2] - p[2]}};
+                    const Vec w = {{r[0] - p[0], r[1] - p[1], r[2] - p[2]}};
+                    // 叉积长度为两倍面积，直接累加即为面积加权
+                    n[0] += u[1] * w[2] - u[2] * w[1];
+                    n[1] += u[2] * w[0] - u[0] * w[2];
+                    n[2] += u[0] * w[1] - u[1] * w[0];
+                }
+                const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (len > 0.0) {
+                    normal[i] = Vec{{n[0] / len, n[1] / len, n[2] / len}};
+                }
+            }
+        }, options.num_threads);
+
+        std::vector<double> vertex_size(nv, max_size);
+        parallel_for(nv, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t i = b; i < e; ++i) {
+                const Vertex_index v(static_cast<typename Mesh::size_type>(i));
+                if (mesh.is_removed(v) || mesh.is_isolated(v)) {
+                    continue;
+                }
+                const Vec p = position(v);
+                double curvature = 0.0;
+                for (Vertex_index u : CGAL::vertices_around_target(mesh.halfedge(v), mesh)) {
+                    const Vec q = position(u);
+                    const double d = std::sqrt((q[0] - p[0]) * (q[0] - p[0]) + (q[1] - p[1]) * (q[1] - p[1]) +
+                                               (q[2] - p[2]) * (q[2] - p[2]));
+                    if (d <= 0.0) {
+                        continue;
+                    }
+                    const Vec& m = normal[i];
+                    const Vec& o = normal[u];
+                    const double dn = std::sqrt((m[0] - o[0]) * (m[0] - o[0]) + (m[1] - o[1]) * (m[1] - o[1]) +
+                                                (m[2] - o[2]) * (m[2] - o[2]));
+                    curvature = std::max(curvature, dn / d);
+                }
+                double h = max_size;
+                if (curvature > 0.0 && options.facet_distance > 0.0) {
+                    h = std::sqrt(8.0 * options.facet_distance / curvature);
+                }
+                vertex_size[i] = std::max(min_size, std::min(max_size, h));
+            }
+        }, options.num_threads);
+
+        // 2. 写入网格：顶点取所在格子的最小值，特征边按半个格子的间距采样
+        for (Vertex_index v : mesh.vertices()) {
+            double& s = size_[cell_of(position(v))];
+            s = std::min(s, vertex_size[v]);
+        }
+        for (auto e : mesh.edges()) {
+            if (!get(eif, e)) {
+                continue;
+            }
+            const Vec p = position(mesh.vertex(e, 0)), q = position(mesh.vertex(e, 1));
+            const double len = std::sqrt((q[0] - p[0]) * (q[0] - p[0]) + (q[1] - p[1]) * (q[1] - p[1]) +
+                                         (q[2] - p[2]) * (q[2] - p[2]));
+            const int samples = 1 + static_cast<int>(2.0 * len * inv_cell_);
+            for (int k = 0; k <= samples; ++k) {
+                const double t = static_cast<double>(k) / samples;
+                const Vec x = {{p[0] + t * (q[0] - p[0]), p[1] + t * (q[1] - p[1]), p[2] + t * (q[2] - p[2])}};
+                double& s = size_[cell_of(x)];
+                s = std::min(s, feature_size);
+            }
+        }
+
+        // 3. 沿各轴正反扫描，尺寸按 grading 随距离增长，各行互不相关，可以并行
+        const double step = options.grading * cell;
+        const std::size_t stride[3] = {1, static_cast<std::size_t>(dims_[0]),
+                                       static_cast<std::size_t>(dims_[0]) * dims_[1]};
+        for (int axis = 0; axis < 3; ++axis) {
+            const int a1 = (axis + 1) % 3, a2 = (axis + 2) % 3;
+            const std::size_t lines = static_cast<std::size_t>(dims_[a1]) * dims_[a2];
+            parallel_for(lines, [&](std::size_t b, std::size_t e, unsigned) {
+                for (std::size_t line = b; line < e; ++line) {
+                    const std::size_t base = (line % dims_[a1]) * stride[a1] + (line / dims_[a1]) * stride[a2];
+                    for (int i = 1; i < dims_[axis]; ++i) {
+                        double& s = size_[base + i * stride[axis]];
+                        s = std::min(s, size_[base + (i - 1) * stride[axis]] + step);
+                    }
+                    for (int i = dims_[axis] - 2; i >= 0; --i) {
+                        double& s = size_[base + i * stride[axis]];
+                        s = std::min(s, size_[base + (i + 1) * stride[axis]] + step);
+                    }
+                }
+            }, options.num_threads, 64);
+        }
+    }
+
+    std::array<double, 3> origin_ = {{0.0, 0.0, 0.0}};
+    double inv_cell_ = 1.0;
+    std::array<int, 3> dims_ = {{1, 1, 1}};
+    std::vector<double> size_;
+};
+
+#endif
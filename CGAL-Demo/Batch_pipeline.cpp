@@ -0,0 +1,431 @@
+#include "Batch_pipeline.h"
+#include "Bounded_queue.h"
+#include "File_util.h"
+#include "Io_ring.h"
+#include "Parallel.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// 字节预算：超出上限时 acquire 阻塞；预算全空时总能取得，超大文件也能单独通过
+class Byte_budget {
+public:
+    explicit Byte_budget(std::size_t limit) : limit_(limit), used_(0) {}
+
+    void acquire(std::size_t bytes) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_.wait(lock, [&]() { return fits(bytes); });
+        used_ += bytes;
+    }
+
+    bool try_acquire(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!fits(bytes)) {
+            return false;
+        }
+        used_ += bytes;
+        return true;
+    }
+
+    // 不受上限约束地追加，用于输出比按输入预留的更大时；不阻塞，避免修复线程与读线程互相等待
+    void grow(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        used_ += bytes;
+    }
+
+    void release(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        used_ -= bytes;
+        released_.notify_all();
+    }
+
+private:
+    bool fits(std::size_t bytes) const { return used_ == 0 || used_ + bytes <= limit_; }
+
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::size_t limit_;
+    std::size_t used_;
+};
+
+// 一个文件在流水线中的全部状态，依次经过读、修复、写三级
+struct Pipeline_job {
+    std::size_t index = 0;
+    std::unique_ptr<char[]> input;
+    std::size_t input_size = 0;
+    std::vector<char> output;
+    // 按输入大小在预算中预留的字节数，写出完成后归还
+    std::size_t reserved = 0;
+    std::string error;
+    Clock::time_point start;
+};
+typedef std::unique_ptr<Pipeline_job> Job_ptr;
+
+// 一个文件的整体读或写
+struct Transfer {
+    Job_ptr job;
+    int fd = -1;
+    char* data = nullptr;
+    std::size_t size = 0;
+    // 已发出的请求覆盖到的偏移
+    std::size_t issued = 0;
+    std::size_t done = 0;
+    unsigned pending = 0;
+    int error = 0;
+};
+
+// 把整文件读写拆成固定大小的请求交给 Io_ring，多个文件的请求交错在途；短读写时补发剩余部分
+class Transfer_engine {
+public:
+    Transfer_engine(bool reading, const Batch_pipeline_options& options)
+        : ring_(options.io_depth, options.use_io_uring), reading_(reading),
+          request_size_(std::max<std::size_t>(4096, std::min<std::size_t>(options.request_size, 1u << 30))),
+          slots_(ring_.available()) {
+        for (unsigned i = 0; i < slots_.size(); ++i) {
+            free_.push_back(i);
+        }
+    }
+
+    bool uses_io_uring() const { return ring_.uses_io_uring(); }
+    std::size_t active() const { return active_.size(); }
+    bool idle() const { return active_.empty() && finished_.empty(); }
+
+    void start(std::unique_ptr<Transfer> transfer) {
+        if (transfer->size == 0) {
+            finished_.push_back(std::move(transfer));
+        } else {
+            active_.push_back(std::move(transfer));
+        }
+    }
+
+    // 发出尽可能多的请求并处理一个完成事件；某个传输因此整体结束（成功或失败）时返回它
+    std::unique_ptr<Transfer> step() {
+        if (finished_.empty()) {
+            issue();
+            Io_completion completion;
+            if (ring_.wait(completion)) {
+                complete(completion);
+            } else {
+                fail_all();
+            }
+        }
+        std::unique_ptr<Transfer> transfer;
+        if (!finished_.empty()) {
+            transfer = std::move(finished_.front());
+            finished_.pop_front();
+        }
+        return transfer;
+    }
+
+private:
+    struct Request {
+        Transfer* transfer;
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    void submit(const Request& request) {
+        const unsigned slot = free_.back();
+        free_.pop_back();
+        slots_[slot] = request;
+        ++request.transfer->pending;
+        char* buffer = request.transfer->data + request.offset;
+        const unsigned length = static_cast<unsigned>(request.length);
+        if (reading_) {
+            ring_.read(request.transfer->fd, buffer, length, request.offset, slot);
+        } else {
+            ring_.write(request.transfer->fd, buffer, length, request.offset, slot);
+        }
+    }
+
+    void issue() {
+        while (ring_.available() > 0 && !retry_.empty()) {
+            Request request = retry_.front();
+            retry_.pop_front();
+            if (request.transfer->error == 0) {
+                submit(request);
+            }
+        }
+        // 先到的文件先发完，使它尽早进入下一级
+        for (auto& transfer : active_) {
+            while (ring_.available() > 0 && transfer->error == 0 && transfer->issued < transfer->size) {
+                const std::size_t length = std::min(request_size_, transfer->size - transfer->issued);
+                submit({transfer.get(), transfer->issued, length});
+                transfer->issued += length;
+            }
+        }
+    }
+
+    void complete(const Io_completion& completion) {
+        const Request request = slots_[completion.user_data];
+        free_.push_back(static_cast<unsigned>(completion.user_data));
+        Transfer* transfer = request.transfer;
+        --transfer->pending;
+        if (completion.result < 0) {
+            transfer->error = -completion.result;
+        } else if (completion.result == 0) {
+            // 读到文件尾或写不进任何字节：文件在处理期间被截断或磁盘已满
+            transfer->error = reading_ ? EIO : ENOSPC;
+        } else {
+            const std::size_t n = static_cast<std::size_t>(completion.result);
+            transfer->done += n;
+            if (n < request.length) {
+                retry_.push_back({transfer, request.offset + n, request.length - n});
+            }
+        }
+        if (transfer->pending == 0 && (transfer->error != 0 || transfer->done == transfer->size)) {
+            finish(transfer);
+        }
+    }
+
+    void finish(Transfer* transfer) {
+        retry_.erase(std::remove_if(retry_.begin(), retry_.end(),
+                                    [transfer](const Request& r) { return r.transfer == transfer; }),
+                     retry_.end());
+        auto it = std::find_if(active_.begin(), active_.end(),
+                               [transfer](const std::unique_ptr<Transfer>& t) { return t.get() == transfer; });
+        finished_.push_back(std::move(*it));
+        active_.erase(it);
+    }
+
+    // io_uring_enter 本身出错时 ring 已不可用，剩余传输全部按失败结束
+    void fail_all() {
+        for (auto& transfer : active_) {
+            if (transfer->error == 0) {
+                transfer->error = EIO;
+            }
+            finished_.push_back(std::move(transfer));
+        }
+        active_.clear();
+        retry_.clear();
+    }
+
+    Io_ring ring_;
+    bool reading_;
+    std::size_t request_size_;
+    std::vector<Request> slots_;
+    std::vector<unsigned> free_;
+    std::deque<Request> retry_;
+    std::deque<std::unique_ptr<Transfer>> active_;
+    std::deque<std::unique_ptr<Transfer>> finished_;
+};
+
+std::string error_text(const char* what, int error) {
+    return std::string(what) + ": " + std::strerror(error);
+}
+
+// 读取级：按顺序预读输入，预算不足时先处理在途读取的完成事件
+void load_stage(const std::vector<Batch_item>& items, const std::vector<std::size_t>& order, unsigned max_open,
+                Byte_budget& budget, Transfer_engine& engine, Bounded_queue<Job_ptr>& out) {
+    std::size_t next = 0;
+    while (next < order.size() || !engine.idle()) {
+        while (next < order.size() && engine.active() < max_open) {
+            const Batch_item& item = items[order[next]];
+            if (engine.idle()) {
+                budget.acquire(item.bytes);
+            } else if (!budget.try_acquire(item.bytes)) {
+                break;
+            }
+            Job_ptr job(new Pipeline_job());
+            job->index = order[next++];
+            job->reserved = item.bytes;
+            job->start = Clock::now();
+
+            int fd = ::open(item.input.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st;
+            if (fd < 0 || ::fstat(fd, &st) != 0) {
+                job->error = error_text("无法打开输入", errno);
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                out.push(std::move(job));
+                continue;
+            }
+            std::unique_ptr<Transfer> transfer(new Transfer());
+            transfer->fd = fd;
+            transfer->size = static_cast<std::size_t>(st.st_size);
+            job->input.reset(new char[std::max<std::size_t>(1, transfer->size)]);
+            job->input_size = transfer->size;
+            transfer->data = job->input.get();
+            transfer->job = std::move(job);
+            engine.start(std::move(transfer));
+        }
+        if (engine.idle()) {
+            continue;
+        }
+        std::unique_ptr<Transfer> transfer = engine.step();
+        if (transfer) {
+            ::close(transfer->fd);
+            if (transfer->error != 0) {
+                transfer->job->error = error_text("读取失败", transfer->error);
+            }
+            out.push(std::move(transfer->job));
+        }
+    }
+    out.close();
+}
+
+// 修复级：在内存中加载、修复并编码为二进制 STL
+void repair_stage(const std::vector<Batch_item>& items, const Repair_options& options, std::size_t total_bytes,
+                  unsigned jobs, Byte_budget& budget, std::vector<Batch_result>& results,
+                  Bounded_queue<Job_ptr>& in, Bounded_queue<Job_ptr>& out) {
+    Job_ptr job;
+    while (in.pop(job)) {
+        if (job->error.empty()) {
+            Batch_result& result = results[job->index];
+            Repair_options job_options = options;
+            job_options.verbose = false;
+            job_options.num_threads = batch_job_threads(options, items[job->index].bytes, total_bytes, jobs);
+            try {
+                LAR_STL stl_processor(job->input.get(), job->input_size, job_options);
+                job->input.reset();
+                const Surface_mesh& mesh = stl_processor.get_repaired_mesh();
+                if (mesh.is_empty()) {
+                    job->error = "加载或修复失败";
+                } else {
+                    result.vertices = mesh.number_of_vertices();
+                    result.faces = mesh.number_of_faces();
+                    result.rejected_facets = stl_processor.get_rejected_facets();
+                    result.manifold = stl_processor.check_manifold().is_manifold();
+                    if (!encode_binary_STL(mesh, job->output, job_options.num_threads)) {
+                        job->error = "编码失败";
+                    }
+                }
+            } catch (const std::exception& e) {
+                job->error = e.what();
+            }
+            job->input.reset();
+            if (job->output.size() > job->reserved) {
+                budget.grow(job->output.size() - job->reserved);
+                job->reserved = job->output.size();
+            }
+        }
+        out.push(std::move(job));
+    }
+}
+
+// 写出级：异步写出编码好的结果，完成后归还预算并记录结果
+void write_stage(const std::vector<Batch_item>& items, unsigned max_open, Byte_budget& budget,
+                 Transfer_engine& engine, std::vector<Batch_result>& results, Bounded_queue<Job_ptr>& in) {
+    std::size_t finished = 0;
+    auto finish_job = [&](Job_ptr job) {
+        Batch_result& result = results[job->index];
+        result.ok = job->error.empty();
+        result.error = job->error;
+        result.seconds = std::chrono::duration<double>(Clock::now() - job->start).count();
+        budget.release(job->reserved);
+        ++finished;
+        std::cout << "[" << finished << "/" << items.size() << "] " << items[job->index].input << " "
+                  << (result.ok ? "成功" : "失败: " + result.error) << " (" << result.seconds << " s)" << std::endl;
+    };
+    auto start_write = [&](Job_ptr job) {
+        int fd = -1;
+        if (job->error.empty()) {
+            const Batch_item& item = items[job->index];
+            const std::string dir = parent_directory(item.output);
+            if (!dir.empty() && !make_directories(dir)) {
+                job->error = "无法创建输出目录";
+            } else if ((fd = ::open(item.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0) {
+                job->error = error_text("保存失败", errno);
+            }
+        }
+        if (fd < 0) {
+            finish_job(std::move(job));
+            return;
+        }
+        std::unique_ptr<Transfer> transfer(new Transfer());
+        transfer->fd = fd;
+        transfer->data = job->output.data();
+        transfer->size = job->output.size();
+        transfer->job = std::move(job);
+        engine.start(std::move(transfer));
+    };
+
+    for (;;) {
+        Job_ptr job;
+        if (engine.idle()) {
+            if (!in.pop(job)) {
+                break;
+            }
+            start_write(std::move(job));
+            continue;
+        }
+        while (engine.active() < max_open && in.try_pop(job)) {
+            start_write(std::move(job));
+        }
+        std::unique_ptr<Transfer> transfer = engine.step();
+        if (transfer) {
+            const int close_error = ::close(transfer->fd) == 0 ? 0 : errno;
+            const int error = transfer->error != 0 ? transfer->error : close_error;
+            if (error != 0) {
+                transfer->job->error = error_text("保存失败", error);
+            }
+            transfer->job->output = std::vector<char>();
+            finish_job(std::move(transfer->job));
+        }
+    }
+}
+
+} // namespace
+
+bool run_batch_pipeline(const std::vector<Batch_item>& items, const Repair_options& options, unsigned jobs,
+                        const Batch_pipeline_options& pipeline, const std::string& summary,
+                        std::vector<Batch_result>& results) {
+    results.assign(items.size(), Batch_result());
+    jobs = resolve_thread_count(jobs);
+
+    // 与 run_batch 相同的最长处理时间优先顺序
+    std::vector<std::size_t> order(items.size());
+    std::size_t total_bytes = 0;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        order[i] = i;
+        total_bytes += items[i].bytes;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return items[a].bytes > items[b].bytes; });
+
+    const unsigned max_open = std::max(1u, pipeline.io_depth);
+    Byte_budget budget(pipeline.memory_budget);
+    // 队列长度与修复线程数相当：每个线程手上一个、队列里再等一个
+    Bounded_queue<Job_ptr> repair_queue(jobs);
+    Bounded_queue<Job_ptr> write_queue(jobs);
+    Transfer_engine reader(true, pipeline);
+    Transfer_engine writer(false, pipeline);
+    std::cout << "流水线批处理：" << (reader.uses_io_uring() ? "io_uring" : "pread/pwrite") << " 读写，" << jobs
+              << " 个修复线程" << std::endl;
+
+    std::thread load_thread(load_stage, std::cref(items), std::cref(order), max_open, std::ref(budget),
+                            std::ref(reader), std::ref(repair_queue));
+    std::thread write_thread(write_stage, std::cref(items), max_open, std::ref(budget), std::ref(writer),
+                             std::ref(results), std::ref(write_queue));
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < jobs; ++i) {
+        workers.emplace_back(repair_stage, std::cref(items), std::cref(options), total_bytes, jobs,
+                             std::ref(budget), std::ref(results), std::ref(repair_queue), std::ref(write_queue));
+    }
+
+    load_thread.join();
+    for (auto& w : workers) {
+        w.join();
+    }
+    write_queue.close();
+    write_thread.join();
+
+    return write_batch_summary(items, results, summary);
+}
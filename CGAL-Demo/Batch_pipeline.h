@@ -0,0 +1,25 @@
+#ifndef LAR_BATCH_PIPELINE_H
+#define LAR_BATCH_PIPELINE_H
+
+#include "Batch_runner.h"
+
+// 流水线批处理参数
+struct Batch_pipeline_options {
+    // 已读入与待写出文件缓冲的合计内存上限（字节）；单个文件超过上限时独占全部预算
+    std::size_t memory_budget = std::size_t(512) << 20;
+    // 读、写线程各自同时在途的 I/O 请求数
+    unsigned io_depth = 64;
+    // 单个读写请求的大小
+    std::size_t request_size = std::size_t(1) << 20;
+    // 为 false 时不尝试 io_uring，直接使用 pread/pwrite
+    bool use_io_uring = true;
+};
+
+// 三级流水线批处理：读线程用 io_uring 预读后续输入，jobs 个工作线程在内存中修复并编码输出，
+// 写线程异步写出结果；各级之间是有界队列，读入的缓冲按预算限流，内存占用有上限
+// 文件按大小从大到小读入，结果与汇总格式同 run_batch
+bool run_batch_pipeline(const std::vector<Batch_item>& items, const Repair_options& options, unsigned jobs,
+                        const Batch_pipeline_options& pipeline, const std::string& summary,
+                        std::vector<Batch_result>& results);
+
+#endif
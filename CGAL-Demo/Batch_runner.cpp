@@ -0,0 +1,211 @@
+#include "Batch_runner.h"
+#include "File_util.h"
+#include "Parallel.h"
+#include "Thread_pool.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+
+namespace {
+
+bool is_directory(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+std::size_t file_size(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+}
+
+std::string base_name(const std::string& path) {
+    std::size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool has_stl_extension(const std::string& name) {
+    if (name.size() < 4) {
+        return false;
+    }
+    std::string ext = name.substr(name.size() - 4);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".stl";
+}
+
+// 递归收集目录下的 STL 文件，relative 为相对输入根目录的路径
+void scan_directory(const std::string& root, const std::string& relative, std::vector<std::string>& found) {
+    const std::string dir = relative.empty() ? root : root + "/" + relative;
+    DIR* d = ::opendir(dir.c_str());
+    if (d == nullptr) {
+        return;
+    }
+    while (dirent* entry = ::readdir(d)) {
+        const std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        const std::string rel = relative.empty() ? name : relative + "/" + name;
+        if (is_directory(root + "/" + rel)) {
+            scan_directory(root, rel, found);
+        } else if (has_stl_extension(name)) {
+            found.push_back(rel);
+        }
+    }
+    ::closedir(d);
+}
+
+std::string csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        return s;
+    }
+    std::string quoted = "\"";
+    for (char c : s) {
+        quoted += (c == '"') ? std::string("\"\"") : std::string(1, c);
+    }
+    return quoted + "\"";
+}
+
+} // namespace
+
+bool collect_batch_items(const std::string& source, const std::string& output_dir, std::vector<Batch_item>& items) {
+    items.clear();
+    if (is_directory(source)) {
+        std::vector<std::string> found;
+        scan_directory(source, "", found);
+        std::sort(found.begin(), found.end());
+        for (const auto& rel : found) {
+            Batch_item item;
+            item.input = source + "/" + rel;
+            item.output = output_dir + "/" + rel;
+            items.push_back(item);
+        }
+    } else {
+        std::ifstream manifest(source);
+        if (!manifest) {
+            std::cerr << "错误：无法打开批处理目录或清单 " << source << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(manifest, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            Batch_item item;
+            std::size_t tab = line.find('\t');
+            item.input = line.substr(0, tab);
+            item.output = tab == std::string::npos ? output_dir + "/" + base_name(item.input) : line.substr(tab + 1);
+            items.push_back(item);
+        }
+    }
+    for (auto& item : items) {
+        item.bytes = file_size(item.input);
+    }
+    return true;
+}
+
+bool run_batch(const std::vector<Batch_item>& items, const Repair_options& options, unsigned jobs,
+               const std::string& summary, std::vector<Batch_result>& results) {
+    results.assign(items.size(), Batch_result());
+    jobs = resolve_thread_count(jobs);
+
+    // 最长处理时间优先：大文件先提交，小文件填补空隙，再由工作窃取平衡剩余负载
+    std::vector<std::size_t> order(items.size());
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return items[a].bytes > items[b].bytes; });
+
+    // 未指定内部线程数时按线程池大小切块；各块由提交它的工作线程放入自己的队列，空闲线程窃取执行
+    const unsigned job_threads = options.num_threads != 0 ? options.num_threads : jobs;
+    std::mutex print_mutex;
+    std::size_t finished = 0;
+    {
+        Thread_pool pool(jobs);
+        // 各文件内部阶段的 parallel_for 也交给这个线程池，总线程数不超过 jobs
+        Parallel_executor_scope executor(&pool);
+        for (std::size_t i : order) {
+            pool.submit([&, i]() {
+                const Batch_item& item = items[i];
+                Batch_result& result = results[i];
+                Repair_options job_options = options;
+                job_options.verbose = false;
+                job_options.num_threads = job_threads;
+
+                auto start = std::chrono::steady_clock::now();
+                try {
+                    LAR_STL stl_processor(item.input, job_options);
+                    const Surface_mesh& mesh = stl_processor.get_repaired_mesh();
+                    if (mesh.is_empty()) {
+                        result.error = "加载或修复失败";
+                    } else {
+                        result.vertices = mesh.number_of_vertices();
+                        result.faces = mesh.number_of_faces();
+                        result.rejected_facets = stl_processor.get_rejected_facets();
+                        result.manifold = stl_processor.check_manifold().is_manifold();
+                        std::string dir = parent_directory(item.output);
+                        if (!dir.empty() && !make_directories(dir)) {
+                            result.error = "无法创建输出目录";
+                        } else if (!stl_processor.save_repaired_mesh(item.output)) {
+                            result.error = "保存失败";
+                        } else {
+                            result.ok = true;
+                        }
+                    }
+                } catch (const std::exception& e) {
+                    result.error = e.what();
+                }
+                result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                std::lock_guard<std::mutex> lock(print_mutex);
+                ++finished;
+                std::cout << "[" << finished << "/" << items.size() << "] " << item.input << " "
+                          << (result.ok ? "成功" : "失败: " + result.error) << " (" << result.seconds << " s)"
+                          << std::endl;
+            });
+        }
+        pool.wait();
+    }
+    return write_batch_summary(items, results, summary);
+}
+
+unsigned batch_job_threads(const Repair_options& options, std::size_t bytes, std::size_t total_bytes, unsigned jobs) {
+    if (options.num_threads != 0) {
+        return options.num_threads;
+    }
+    // 占总字节数比例大的文件在内部阶段使用更多线程
+    double share = total_bytes > 0 ? double(bytes) / total_bytes : 0.0;
+    return std::max(1u, std::min(jobs, static_cast<unsigned>(std::lround(share * jobs))));
+}
+
+bool write_batch_summary(const std::vector<Batch_item>& items, const std::vector<Batch_result>& results,
+                         const std::string& summary) {
+    const std::string summary_dir = parent_directory(summary);
+    if (!summary_dir.empty()) {
+        make_directories(summary_dir);
+    }
+    std::ofstream csv(summary);
+    if (!csv) {
+        std::cerr << "错误：无法写入结果汇总 " << summary << std::endl;
+        return false;
+    }
+    csv << "input,output,status,vertices,faces,rejected_facets,manifold,seconds,error\n";
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const Batch_result& r = results[i];
+        failed += !r.ok;
+        csv << csv_field(items[i].input) << ',' << csv_field(items[i].output) << ',' << (r.ok ? "ok" : "failed") << ','
+            << r.vertices << ',' << r.faces << ',' << r.rejected_facets << ',' << (r.manifold ? 1 : 0) << ',' << r.seconds << ','
+            << csv_field(r.error) << '\n';
+    }
+    std::cout << "批处理完成：" << items.size() - failed << " 成功，" << failed << " 失败，汇总见 " << summary
+              << std::endl;
+    return failed == 0;
+}
@@ -0,0 +1,45 @@
+#ifndef LAR_BATCH_RUNNER_H
+#define LAR_BATCH_RUNNER_H
+
+#include "LAR_STL.h"
+
+#include <string>
+#include <vector>
+
+// 批处理中的一个文件
+struct Batch_item {
+    std::string input;
+    std::string output;
+    std::size_t bytes = 0;
+};
+
+// 单个文件的修复结果
+struct Batch_result {
+    bool ok = false;
+    bool manifold = false;
+    std::size_t vertices = 0;
+    std::size_t faces = 0;
+    // 建网格时被丢弃的面片数
+    std::size_t rejected_facets = 0;
+    double seconds = 0.0;
+    std::string error;
+};
+
+// 收集批处理输入：source 是目录时取其中（含子目录）所有 .stl 文件，
+// 否则视为清单文件，每行一个输入路径，可用制表符分隔再给出输出路径
+bool collect_batch_items(const std::string& source, const std::string& output_dir, std::vector<Batch_item>& items);
+
+// 在工作窃取线程池上为每个文件运行一次 LAR_STL 流程，并把逐文件结果写入 summary（CSV）
+// 文件按大小从大到小提交；线程池同时作为各文件内部 parallel_for 的执行器，
+// 大文件切出的块进入当前工作线程的队列，由空闲线程窃取，总线程数不超过 jobs
+bool run_batch(const std::vector<Batch_item>& items, const Repair_options& options, unsigned jobs,
+               const std::string& summary, std::vector<Batch_result>& results);
+
+// 未指定内部线程数时，按文件占总字节数的比例分配 jobs 个线程，至少 1 个（流水线批处理的修复级使用）
+unsigned batch_job_threads(const Repair_options& options, std::size_t bytes, std::size_t total_bytes, unsigned jobs);
+
+// 写出逐文件结果汇总（CSV）并打印成功/失败计数；全部成功时返回 true
+bool write_batch_summary(const std::vector<Batch_item>& items, const std::vector<Batch_result>& results,
+                         const std::string& summary);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef LAR_BOUNDED_QUEUE_H
+#define LAR_BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// 有界阻塞队列：满时 push 阻塞，使上游阶段不会跑在下游前面无限堆积数据
+// close 之后 push 失败，pop 取完剩余元素后返回 false
+template <typename T>
+class Bounded_queue {
+public:
+    explicit Bounded_queue(std::size_t capacity) : capacity_(capacity > 0 ? capacity : 1), closed_(false) {}
+
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        return take(value);
+    }
+
+    // 不阻塞：队列为空时立即返回 false
+    bool try_pop(T& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return take(value);
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    bool take(T& value) {
+        if (items_.empty()) {
+            return false;
+        }
+        value = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+    std::size_t capacity_;
+    bool closed_;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef LAR_COMPONENT_REPAIR_H
+#define LAR_COMPONENT_REPAIR_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/Polygon_mesh_processing/repair.h>
+#include <CGAL/Polygon_mesh_processing/stitch_borders.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// 按分量修复结果
+struct Component_repair_report {
+    std::size_t components = 0;
+    std::size_t isolated_vertices = 0;
+    std::size_t duplicated_vertices = 0;
+};
+
+namespace internal_component_repair {
+
+const std::uint32_t invalid = std::numeric_limits<std::uint32_t>::max();
+
+inline std::uint32_t find_root(std::vector<std::uint32_t>& parent, std::uint32_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+// 把一个分量的面连同其边、顶点与边界半边的连接关系原样复制到空网格 sub
+// vlocal / elocal / flocal 为全局下标到分量内下标的映射，各分量的元素互不相交，可由各线程并发填写
+// 遇到引用了分量外元素的结构（如两侧都没有面的悬空边）时返回 false
+template <typename Mesh>
+bool copy_component(const Mesh& mesh, const std::vector<typename Mesh::Face_index>& faces, Mesh& sub,
+                    std::vector<std::uint32_t>& vlocal, std::vector<std::uint32_t>& elocal,
+                    std::vector<std::uint32_t>& flocal) {
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+    typedef typename Mesh::Edge_index Edge_index;
+    typedef typename Mesh::Face_index Face_index;
+    typedef typename Mesh::size_type size_type;
+
+    std::vector<Vertex_index> vertices;
+    std::vector<Edge_index> edges;
+    for (std::size_t i = 0; i < faces.size(); ++i) {
+        flocal[faces[i]] = static_cast<std::uint32_t>(i);
+        for (Halfedge_index h : CGAL::halfedges_around_face(mesh.halfedge(faces[i]), mesh)) {
+            const Vertex_index v = mesh.target(h);
+            if (vlocal[v] == invalid) {
+                vlocal[v] = static_cast<std::uint32_t>(vertices.size());
+                vertices.push_back(v);
+            }
+            const Edge_index e = mesh.edge(h);
+            if (elocal[e] == invalid) {
+                elocal[e] = static_cast<std::uint32_t>(edges.size());
+                edges.push_back(e);
+            }
+        }
+    }
+
+    // Surface_mesh 中边 e 的两条半边编号为 2e 与 2e+1
+    auto local_halfedge = [&](Halfedge_index h) {
+        const std::uint32_t e = elocal[mesh.edge(h)];
+        return e == invalid ? Mesh::null_halfedge() : Halfedge_index(static_cast<size_type>(2 * e + (h.idx() & 1)));
+    };
+
+    sub.reserve(static_cast<size_type>(vertices.size()), static_cast<size_type>(edges.size()),
+                static_cast<size_type>(faces.size()));
+    for (Vertex_index v : vertices) {
+        sub.add_vertex(mesh.point(v));
+    }
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        sub.add_edge();
+    }
+    for (Face_index f : faces) {
+        sub.set_halfedge(sub.add_face(), local_halfedge(mesh.halfedge(f)));
+    }
+    for (Edge_index e : edges) {
+        for (int j = 0; j < 2; ++j) {
+            const Halfedge_index h = mesh.halfedge(e, j);
+            const Halfedge_index lh = local_halfedge(h);
+            const Halfedge_index next = local_halfedge(mesh.next(h));
+            if (next == Mesh::null_halfedge()) {
+                return false;
+            }
+            sub.set_target(lh, Vertex_index(static_cast<size_type>(vlocal[mesh.target(h)])));
+            sub.set_next(lh, next);
+            const Face_index f = mesh.face(h);
+            sub.set_face(lh, f == Mesh::null_face() ? Mesh::null_face()
+                                                    : Face_index(static_cast<size_type>(flocal[f])));
+        }
+    }
+    for (Vertex_index v : vertices) {
+        const Halfedge_index h = local_halfedge(mesh.halfedge(v));
+        if (h == Mesh::null_halfedge()) {
+            return false;
+        }
+        sub.set_halfedge(Vertex_index(static_cast<size_type>(vlocal[v])), h);
+    }
+    return true;
+}
+
+} // namespace internal_component_repair
+
+// 按连通分量并行执行孤立顶点移除、非流形顶点复制与边界缝合：
+// 1. 以共享顶点为相连，用并查集标记分量，分量按其首个面的编号排序
+// 2. 各分量原样复制到独立的子网格，在子网格上串行执行三个步骤，分量之间并行（大分量先领取）
+// 3. 按分量顺序把子网格拼接回原网格；孤立顶点不属于任何分量，自然被丢弃
+// 焊接后坐标相同的点已是同一顶点，这三步都不会跨越分量，因此与整体修复等价；
+// 每个子网格的处理是串行且确定的，合并顺序固定，结果与线程数无关
+// 只有一个分量或遇到无法按分量拆分的结构时返回 false，网格保持不变，调用者应改走整体修复
+template <typename Point>
+bool repair_components_in_parallel(CGAL::Surface_mesh<Point>& mesh, unsigned num_threads,
+                                   Component_repair_report& report) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+    typedef typename Mesh::Face_index Face_index;
+    using internal_component_repair::invalid;
+    namespace PMP = CGAL::Polygon_mesh_processing;
+
+    report = Component_repair_report();
+    std::vector<std::uint32_t> parent(mesh.num_vertices());
+    std::iota(parent.begin(), parent.end(), 0u);
+    for (Face_index f : mesh.faces()) {
+        const std::uint32_t first = internal_component_repair::find_root(parent, mesh.target(mesh.halfedge(f)));
+        for (Halfedge_index h : CGAL::halfedges_around_face(mesh.halfedge(f), mesh)) {
+            const std::uint32_t r = internal_component_repair::find_root(parent, mesh.target(h));
+            if (r != first) {
+                parent[r] = first;
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> component_of_root(mesh.num_vertices(), invalid);
+    std::vector<std::vector<Face_index>> faces;
+    for (Face_index f : mesh.faces()) {
+        std::uint32_t& c = component_of_root[internal_component_repair::find_root(parent, mesh.target(mesh.halfedge(f)))];
+        if (c == invalid) {
+            c = static_cast<std::uint32_t>(faces.size());
+            faces.emplace_back();
+        }
+        faces[c].push_back(f);
+    }
+    report.components = faces.size();
+    if (faces.size() < 2) {
+        return false;
+    }
+    std::vector<std::uint32_t>().swap(parent);
+    std::vector<std::uint32_t>().swap(component_of_root);
+
+    // 大分量先领取，避免最后只剩一个线程在处理最大的分量
+    std::vector<std::size_t> order(faces.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return faces[a].size() > faces[b].size(); });
+
+    std::vector<std::uint32_t> vlocal(mesh.num_vertices(), invalid);
+    std::vector<std::uint32_t> elocal(mesh.num_edges(), invalid);
+    std::vector<std::uint32_t> flocal(mesh.num_faces(), invalid);
+    std::vector<Mesh> subs(faces.size());
+    std::vector<std::size_t> duplicated(faces.size(), 0);
+    std::vector<char> copied(faces.size(), 0);
+    parallel_for_dynamic(order.size(), [&](std::size_t i, unsigned) {
+        const std::size_t c = order[i];
+        copied[c] = internal_component_repair::copy_component(mesh, faces[c], subs[c], vlocal, elocal, flocal);
+        if (!copied[c]) {
+            return;
+        }
+        duplicated[c] = PMP::duplicate_non_manifold_vertices(subs[c]);
+        PMP::stitch_borders(subs[c]);
+        subs[c].collect_garbage();
+    }, num_threads);
+    if (std::find(copied.begin(), copied.end(), 0) != copied.end()) {
+        return false;
+    }
+
+    std::size_t nv = 0, ne = 0, nf = 0;
+    for (std::size_t c = 0; c < subs.size(); ++c) {
+        nv += subs[c].number_of_vertices();
+        ne += subs[c].number_of_edges();
+        nf += subs[c].number_of_faces();
+        report.duplicated_vertices += duplicated[c];
+    }
+    std::size_t used_vertices = 0;
+    for (Vertex_index v : mesh.vertices()) {
+        used_vertices += vlocal[v] != invalid;
+    }
+    report.isolated_vertices = mesh.number_of_vertices() - used_vertices;
+
+    Mesh merged;
+    merged.reserve(static_cast<typename Mesh::size_type>(nv), static_cast<typename Mesh::size_type>(ne),
+                   static_cast<typename Mesh::size_type>(nf));
+    for (std::size_t c = 0; c < subs.size(); ++c) {
+        merged += subs[c];
+        subs[c] = Mesh();
+    }
+    mesh = std::move(merged);
+    return true;
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include "Damaged_mesh_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+// 圆环面的大半径与小半径（毫米）
+const double major_radius = 50.0;
+const double minor_radius = 15.0;
+// 近重复顶点的扰动量，远小于常用的焊接容差，但大于 float 在该量级上的精度
+const double duplicate_jitter = 1e-3;
+
+struct Vec {
+    double x, y, z;
+};
+
+Vec operator+(const Vec& a, const Vec& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+Vec operator-(const Vec& a, const Vec& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+Vec operator*(double s, const Vec& a) { return {s * a.x, s * a.y, s * a.z}; }
+
+// 带缓冲的二进制 STL 写出器，面片数在打开时写入头部
+class STL_writer {
+public:
+    STL_writer(const std::string& filename, std::uint32_t facets) : file_(std::fopen(filename.c_str(), "wb")) {
+        buffer_.reserve(1 << 20);
+        if (file_ == nullptr) {
+            return;
+        }
+        char header[80] = {0};
+        std::strncpy(header, "lar_stl synthetic damaged mesh", sizeof(header) - 1);
+        append(header, sizeof(header));
+        append(&facets, sizeof(facets));
+    }
+    ~STL_writer() { close(); }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    void facet(const Vec& a, const Vec& b, const Vec& c) {
+        Vec u = b - a, v = c - a;
+        Vec n = {u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x};
+        const double len = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+        n = len > 0 ? (1.0 / len) * n : Vec{0, 0, 0};
+        float record[12] = {float(n.x), float(n.y), float(n.z), float(a.x), float(a.y), float(a.z),
+                            float(b.x), float(b.y), float(b.z), float(c.x), float(c.y), float(c.z)};
+        append(record, sizeof(record));
+        const std::uint16_t attribute = 0;
+        append(&attribute, sizeof(attribute));
+    }
+
+    bool close() {
+        if (file_ == nullptr) {
+            return ok_;
+        }
+        flush();
+        ok_ = ok_ && std::fclose(file_) == 0;
+        file_ = nullptr;
+        return ok_;
+    }
+
+private:
+    void append(const void* data, std::size_t n) {
+        const char* p = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), p, p + n);
+        if (buffer_.size() >= (1 << 20)) {
+            flush();
+        }
+    }
+    void flush() {
+        if (!buffer_.empty() && std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+            ok_ = false;
+        }
+        buffer_.clear();
+    }
+
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    bool ok_ = true;
+};
+
+// 圆环面的参数化：i 沿大圆，j 沿小圆
+struct Torus {
+    std::size_t nu, nv;
+
+    Vec normal(std::size_t i, std::size_t j) const {
+        const double u = 2 * pi * double(i % nu) / double(nu);
+        const double v = 2 * pi * double(j % nv) / double(nv);
+        return {std::cos(v) * std::cos(u), std::cos(v) * std::sin(u), std::sin(v)};
+    }
+    Vec point(std::size_t i, std::size_t j) const {
+        const double u = 2 * pi * double(i % nu) / double(nu);
+        return Vec{major_radius * std::cos(u), major_radius * std::sin(u), 0} + minor_radius * normal(i, j);
+    }
+    Vec tangent_u(std::size_t i) const {
+        const double u = 2 * pi * double(i % nu) / double(nu);
+        return {-std::sin(u), std::cos(u), 0};
+    }
+    Vec tangent_v(std::size_t i, std::size_t j) const {
+        const double u = 2 * pi * double(i % nu) / double(nu);
+        const double v = 2 * pi * double(j % nv) / double(nv);
+        return {-std::sin(v) * std::cos(u), -std::sin(v) * std::sin(u), std::cos(v)};
+    }
+};
+
+} // namespace
+
+std::size_t generate_damaged_STL(const std::string& filename, const Defect_options& options) {
+    Torus torus;
+    torus.nv = std::max<std::size_t>(3, static_cast<std::size_t>(std::lround(std::sqrt(options.facets / 4.0))));
+    torus.nu = std::max<std::size_t>(3, (options.facets + torus.nv) / (2 * torus.nv));
+    const std::size_t surface_facets = 2 * torus.nu * torus.nv;
+
+    std::mt19937 rng(options.seed);
+
+    // 裂缝：第 j0 行从 i0 开始的一段面片使用外移后的第 j0 圈顶点
+    std::unordered_set<std::size_t> cracked;
+    const std::size_t crack_length = std::max<std::size_t>(1, std::min<std::size_t>(8, torus.nu / 4));
+    for (std::size_t g = 0; g < options.gaps; ++g) {
+        const std::size_t i0 = rng() % torus.nu;
+        const std::size_t j0 = rng() % torus.nv;
+        for (std::size_t k = 0; k < crack_length; ++k) {
+            cracked.insert(((i0 + k) % torus.nu) * torus.nv + j0);
+        }
+    }
+
+    // 非流形顶点：互不相同的曲面顶点
+    std::set<std::pair<std::size_t, std::size_t>> apexes;
+    const std::size_t nm = std::min(options.non_manifold_vertices, torus.nu * torus.nv);
+    while (apexes.size() < nm) {
+        apexes.insert(std::make_pair(rng() % torus.nu, rng() % torus.nv));
+    }
+
+    const std::size_t total = surface_facets + 4 * apexes.size() + options.isolated_vertices;
+    if (total > UINT32_MAX) {
+        std::fprintf(stderr, "面片数超出二进制 STL 上限: %zu\n", total);
+        return 0;
+    }
+    STL_writer writer(filename, static_cast<std::uint32_t>(total));
+    if (!writer.is_open()) {
+        return 0;
+    }
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (std::size_t i = 0; i < torus.nu; ++i) {
+        for (std::size_t j = 0; j < torus.nv; ++j) {
+            Vec p00 = torus.point(i, j), p10 = torus.point(i + 1, j);
+            const Vec p11 = torus.point(i + 1, j + 1), p01 = torus.point(i, j + 1);
+            if (cracked.count(i * torus.nv + j)) {
+                p00 = p00 + options.gap_width * torus.normal(i, j);
+                p10 = p10 + options.gap_width * torus.normal(i + 1, j);
+            }
+            const Vec quads[2][3] = {{p00, p10, p11}, {p00, p11, p01}};
+            for (const auto& q : quads) {
+                Vec t[3] = {q[0], q[1], q[2]};
+                if (options.duplicate_ratio > 0 && unit(rng) < options.duplicate_ratio) {
+                    t[0] = t[0] + duplicate_jitter * torus.normal(i, j);
+                }
+                if (options.flipped_ratio > 0 && unit(rng) < options.flipped_ratio) {
+                    std::swap(t[1], t[2]);
+                }
+                writer.facet(t[0], t[1], t[2]);
+            }
+        }
+    }
+
+    // 在顶点上挂小四面体：高度取半条边长，只与曲面共享这一个顶点
+    const double h = 0.5 * 2 * pi * minor_radius / double(torus.nv);
+    for (const auto& a : apexes) {
+        const Vec apex = torus.point(a.first, a.second);
+        const Vec n = torus.normal(a.first, a.second);
+        const Vec tu = torus.tangent_u(a.first), tv = torus.tangent_v(a.first, a.second);
+        const Vec center = apex + h * n;
+        Vec base[3];
+        for (int k = 0; k < 3; ++k) {
+            const double theta = 2 * pi * k / 3.0;
+            base[k] = center + (0.5 * h) * (std::cos(theta) * tu + std::sin(theta) * tv);
+        }
+        writer.facet(base[0], base[1], base[2]);
+        writer.facet(apex, base[1], base[0]);
+        writer.facet(apex, base[2], base[1]);
+        writer.facet(apex, base[0], base[2]);
+    }
+
+    // 孤立顶点：放在圆环中心的轴线上，远离曲面
+    for (std::size_t k = 0; k < options.isolated_vertices; ++k) {
+        const double z = -minor_radius + 2 * minor_radius * (double(k) + 0.5) / double(options.isolated_vertices);
+        const Vec p = {0, 0, z};
+        writer.facet(p, p, p);
+    }
+
+    return writer.close() ? total : 0;
+}
@@ -0,0 +1,30 @@
+#ifndef LAR_DAMAGED_MESH_GENERATOR_H
+#define LAR_DAMAGED_MESH_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+
+// 合成缺陷网格的参数：基础曲面是一个闭合圆环面，按需注入各类缺陷
+struct Defect_options {
+    // 圆环面的目标面片数（实际值取最接近的 2 * nu * nv，不含注入的额外面片）
+    std::size_t facets = 10000;
+    // 裂缝条数：沿一圈小环把一段面片整体外移，留下宽度为 gap_width 的缝隙
+    std::size_t gaps = 0;
+    double gap_width = 0.01;
+    // 含近重复顶点的面片比例：该面片的一个角点被微小扰动，精确焊接时会多出一个顶点
+    double duplicate_ratio = 0.0;
+    // 非流形顶点个数：在曲面顶点上各挂一个只共享该顶点的小四面体
+    std::size_t non_manifold_vertices = 0;
+    // 孤立顶点个数：三个角点重合的退化面片，建网格时面被丢弃，只留下顶点
+    std::size_t isolated_vertices = 0;
+    // 法向翻转的面片比例
+    double flipped_ratio = 0.0;
+    // 随机种子，相同参数与种子生成的文件逐字节相同
+    std::uint32_t seed = 1;
+};
+
+// 按参数生成二进制 STL 并流式写出，内存占用与面片数无关，可生成上亿面片的文件
+// 返回写出的总面片数，失败时返回 0
+std::size_t generate_damaged_STL(const std::string& filename, const Defect_options& options);
+
+#endif
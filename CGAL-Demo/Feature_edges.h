@@ -0,0 +1,280 @@
+#ifndef LAR_FEATURE_EDGES_H
+#define LAR_FEATURE_EDGES_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace internal_feature_edges {
+
+// 一块边的四个相关顶点（边的两端 a、b 与两侧面的对顶点 c、d），按分量分开存放，便于 SIMD 成组计算
+struct Edge_block {
+    static constexpr std::size_t capacity = 1024;
+    std::size_t size = 0;
+    // corner[c][k][i]：第 i 条边第 k 个顶点（a, b, c, d）的第 c 个坐标分量
+    double corner[3][4][capacity];
+};
+
+// 两侧面法向夹角的余弦：n1 = (b - a) × (c - a)，n2 = (a - b) × (d - b)；任一法向为零时返回 1（视为平坦）
+inline void dihedral_cosines(const Edge_block& b, double* cosine) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    // 每次两条边：两个法向、点积与长度都成组计算，只有最后的除法分支按通道处理
+    for (; i + 2 <= b.size; i += 2) {
+        __m128d p[4][3];
+        for (int k = 0; k < 4; ++k) {
+            for (int c = 0; c < 3; ++c) {
+                p[k][c] = _mm_loadu_pd(&b.corner[c][k][i]);
+            }
+        }
+        __m128d u[3], v[3], w[3], x[3];
+        for (int c = 0; c < 3; ++c) {
+            u[c] = _mm_sub_pd(p[1][c], p[0][c]);
+            v[c] = _mm_sub_pd(p[2][c], p[0][c]);
+            w[c] = _mm_sub_pd(p[0][c], p[1][c]);
+            x[c] = _mm_sub_pd(p[3][c], p[1][c]);
+        }
+        __m128d n1[3], n2[3];
+        for (int c = 0; c < 3; ++c) {
+            const int c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+            n1[c] = _mm_sub_pd(_mm_mul_pd(u[c1], v[c2]), _mm_mul_pd(u[c2], v[c1]));
+            n2[c] = _mm_sub_pd(_mm_mul_pd(w[c1], x[c2]), _mm_mul_pd(w[c2], x[c1]));
+        }
+        __m128d dot = _mm_setzero_pd(), l1 = _mm_setzero_pd(), l2 = _mm_setzero_pd();
+        for (int c = 0; c < 3; ++c) {
+            dot = _mm_add_pd(dot, _mm_mul_pd(n1[c], n2[c]));
+            l1 = _mm_add_pd(l1, _mm_mul_pd(n1[c], n1[c]));
+            l2 = _mm_add_pd(l2, _mm_mul_pd(n2[c], n2[c]));
+        }
+        double d[2], len[2];
+        _mm_storeu_pd(d, dot);
+        _mm_storeu_pd(len, _mm_sqrt_pd(_mm_mul_pd(l1, l2)));
+        for (int j = 0; j < 2; ++j) {
+            cosine[i + j] = len[j] > 0.0 ? d[j] / len[j] : 1.0;
+        }
+    }
+#endif
+    for (; i < b.size; ++i) {
+        double n[2][3];
+        for (int side = 0; side < 2; ++side) {
+            const int o = side == 0 ? 0 : 1, t = side == 0 ? 1 : 0, apex = side == 0 ? 2 : 3;
+            double u[3], v[3];
+            for (int c = 0; c < 3; ++c) {
+                u[c] = b.corner[c][t][i] - b.corner[c][o][i];
+                v[c] = b.corner[c][apex][i] - b.corner[c][o][i];
+            }
+            n[side][0] = u[1] * v[2] - u[2] * v[1];
+            n[side][1] = u[2] * v[0] - u[0] * v[2];
+            n[side][2] = u[0] * v[1] - u[1] * v[0];
+        }
+        const double dot = n[0][0] * n[1][0] + n[0][1] * n[1][1] + n[0][2] * n[1][2];
+        const double len = std::sqrt((n[0][0] * n[0][0] + n[0][1] * n[0][1] + n[0][2] * n[0][2]) *
+                                     (n[1][0] * n[1][0] + n[1][1] * n[1][1] + n[1][2] * n[1][2]));
+        cosine[i] = len > 0.0 ? dot / len : 1.0;
+    }
+}
+
+inline std::uint64_t mix(std::uint64_t h, std::uint64_t x) {
+    h ^= x + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 29);
+}
+
+inline std::uint64_t mix(std::uint64_t h, double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return mix(h, bits);
+}
+
+// 网格指纹：顶点坐标与每条半边的目标顶点；按固定大小分块并行计算，再按块序合并，结果与线程数无关
+// 顶点移动或连接关系改变而元素数量不变时，指纹随之改变
+template <typename Point>
+std::uint64_t mesh_fingerprint(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    const std::size_t nv = mesh.num_vertices(), nh = mesh.num_halfedges();
+    const std::size_t block = 1 << 16;
+    const std::size_t nbv = (nv + block - 1) / block, nbh = (nh + block - 1) / block;
+    std::vector<std::uint64_t> hashes(nbv + nbh, 0);
+    parallel_for_dynamic(hashes.size(), [&](std::size_t b, unsigned) {
+        std::uint64_t h = b;
+        if (b < nbv) {
+            for (std::size_t i = b * block, end = std::min(nv, i + block); i < end; ++i) {
+                const typename Mesh::Vertex_index v(static_cast<typename Mesh::size_type>(i));
+                if (mesh.is_removed(v)) {
+                    h = mix(h, ~std::uint64_t(0));
+                    continue;
+                }
+                const Point& p = mesh.point(v);
+                for (int c = 0; c < 3; ++c) {
+                    h = mix(h, CGAL::to_double(p[c]));
+                }
+            }
+        } else {
+            const std::size_t hb = b - nbv;
+            for (std::size_t i = hb * block, end = std::min(nh, i + block); i < end; ++i) {
+                const typename Mesh::Halfedge_index he(static_cast<typename Mesh::size_type>(i));
+                h = mix(h, mesh.is_removed(he) ? ~std::uint64_t(0) : static_cast<std::uint64_t>(mesh.target(he)));
+            }
+        }
+        hashes[b] = h;
+    }, num_threads);
+    std::uint64_t h = 0;
+    for (std::uint64_t x : hashes) {
+        h = mix(h, x);
+    }
+    return h;
+}
+
+} // namespace internal_feature_edges
+
+// 特征边缓存：每条边两侧面法向的夹角（度，0 为平坦）只计算一次，任意阈值的尖锐边查询都直接读取；
+// 边界边记为无穷大，任何阈值下都是尖锐边（与 detect_sharp_edges 一致）
+// 按边编号存放，可与网格一起保存，之后的阶段只要网格的元素数量与指纹（顶点坐标、连接关系）不变即可直接载入
+class Feature_edge_cache {
+public:
+    // 边按固定大小分块在线程间动态分配：每块先沿半边收集四个顶点，再用 SSE2 成组计算夹角
+    template <typename Point>
+    void compute(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+        typedef CGAL::Surface_mesh<Point> Mesh;
+        typedef internal_feature_edges::Edge_block Edge_block;
+
+        set_signature(mesh, num_threads);
+        const std::size_t ne = mesh.num_edges();
+        angles_.assign(ne, 0.0f);
+        const std::size_t nb = (ne + Edge_block::capacity - 1) / Edge_block::capacity;
+        std::vector<std::unique_ptr<Edge_block>> blocks(parallel_chunk_count(nb, num_threads, 1));
+        parallel_for_dynamic(nb, [&](std::size_t b, unsigned t) {
+            if (!blocks[t]) {
+                blocks[t].reset(new Edge_block());
+            }
+            Edge_block& block = *blocks[t];
+            // slot[j]：块内第 j 条边在 SoA 中的位置，-1 表示已删除的边、-2 表示边界边
+            std::ptrdiff_t slot[Edge_block::capacity];
+            const std::size_t begin = b * Edge_block::capacity, end = std::min(ne, begin + Edge_block::capacity);
+            block.size = 0;
+            for (std::size_t e = begin; e < end; ++e) {
+                const typename Mesh::Edge_index edge(static_cast<typename Mesh::size_type>(e));
+                if (mesh.is_removed(edge)) {
+                    slot[e - begin] = -1;
+                    continue;
+                }
+                const typename Mesh::Halfedge_index h = mesh.halfedge(edge), o = mesh.opposite(h);
+                if (mesh.is_border(h) || mesh.is_border(o)) {
+                    slot[e - begin] = -2;
+                    continue;
+                }
+                const std::size_t s = block.size++;
+                slot[e - begin] = static_cast<std::ptrdiff_t>(s);
+                const Point* p[4] = {&mesh.point(mesh.source(h)), &mesh.point(mesh.target(h)),
+                                     &mesh.point(mesh.target(mesh.next(h))), &mesh.point(mesh.target(mesh.next(o)))};
+                for (int k = 0; k < 4; ++k) {
+                    for (int c = 0; c < 3; ++c) {
+                        block.corner[c][k][s] = CGAL::to_double((*p[k])[c]);
+                    }
+                }
+            }
+            double cosine[Edge_block::capacity];
+            internal_feature_edges::dihedral_cosines(block, cosine);
+            for (std::size_t e = begin; e < end; ++e) {
+                const std::ptrdiff_t s = slot[e - begin];
+                angles_[e] = s == -1 ? 0.0f
+                             : s == -2 ? std::numeric_limits<float>::infinity()
+                                       : static_cast<float>(std::acos(std::max(-1.0, std::min(1.0, cosine[s]))) *
+                                                            180.0 / M_PI);
+            }
+        }, num_threads);
+    }
+
+    bool empty() const { return angles_.empty(); }
+    std::size_t size() const { return angles_.size(); }
+    // 第 e 条边两侧面法向的夹角（度）
+    float angle(std::size_t e) const { return angles_[e]; }
+    // 夹角大于 threshold（度）即为尖锐边；threshold 不大于 0 时所有边都是尖锐边
+    bool is_sharp(std::size_t e, double threshold) const {
+        return threshold <= 0.0 ? true : static_cast<double>(angles_[e]) > threshold;
+    }
+
+    // 按阈值写入边的特征标记（已删除的边除外），返回尖锐边数
+    template <typename Point, typename EdgeIsFeatureMap>
+    std::size_t mark_sharp_edges(const CGAL::Surface_mesh<Point>& mesh, double threshold,
+                                 EdgeIsFeatureMap eif) const {
+        std::size_t sharp = 0;
+        for (auto e : mesh.edges()) {
+            const bool s = is_sharp(e, threshold);
+            put(eif, e, s);
+            sharp += s;
+        }
+        return sharp;
+    }
+
+    // 与网格一起保存时使用的路径：网格文件名后加 ".features"
+    static std::string path_for(const std::string& mesh_filename) { return mesh_filename + ".features"; }
+
+    // 二进制格式：魔数、顶点/边/面数量与网格指纹（用于校验），之后为每条边的夹角
+    bool save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            return false;
+        }
+        const std::uint64_t header[5] = {magic(), signature_[0], signature_[1], signature_[2], signature_[3]};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(angles_.data()), angles_.size() * sizeof(float));
+        return static_cast<bool>(out);
+    }
+
+    // 文件不存在、格式不符或与 mesh 的元素数量、指纹不一致时返回 false，缓存保持不变
+    // 指纹需遍历顶点与半边，代价远低于重新计算夹角
+    template <typename Point>
+    bool load(const std::string& path, const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+        std::ifstream in(path, std::ios::binary);
+        std::uint64_t header[5];
+        if (!in || !in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != magic() ||
+            header[1] != mesh.num_vertices() || header[2] != mesh.num_edges() || header[3] != mesh.num_faces() ||
+            header[4] != internal_feature_edges::mesh_fingerprint(mesh, num_threads)) {
+            return false;
+        }
+        std::vector<float> angles(static_cast<std::size_t>(header[2]));
+        if (!in.read(reinterpret_cast<char*>(angles.data()), angles.size() * sizeof(float))) {
+            return false;
+        }
+        angles_.swap(angles);
+        std::copy(header + 1, header + 5, signature_);
+        return true;
+    }
+
+private:
+    static std::uint64_t magic() {
+        std::uint64_t m;
+        std::memcpy(&m, "LARFEAT2", sizeof(m));
+        return m;
+    }
+
+    template <typename Point>
+    void set_signature(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads) {
+        signature_[0] = mesh.num_vertices();
+        signature_[1] = mesh.num_edges();
+        signature_[2] = mesh.num_faces();
+        signature_[3] = internal_feature_edges::mesh_fingerprint(mesh, num_threads);
+    }
+
+    std::vector<float> angles_;
+    // 顶点/边/面数量与网格指纹
+    std::uint64_t signature_[4] = {0, 0, 0, 0};
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "File_util.h"
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+bool make_directories(const std::string& path) {
+    for (std::size_t pos = 1; pos <= path.size(); ++pos) {
+        if (pos == path.size() || path[pos] == '/') {
+            std::string prefix = path.substr(0, pos);
+            if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::string parent_directory(const std::string& path) {
+    std::size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+bool copy_file(const std::string& from, const std::string& to) {
+    int in = ::open(from.c_str(), O_RDONLY);
+    if (in < 0) {
+        return false;
+    }
+    struct stat st;
+    int out = ::fstat(in, &st) == 0 ? ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+    bool ok = out >= 0;
+    off_t offset = 0;
+    while (ok && offset < st.st_size) {
+        ssize_t n = ::sendfile(out, in, &offset, static_cast<std::size_t>(st.st_size - offset));
+        if (n <= 0 && !(n < 0 && errno == EINTR)) {
+            ok = false;
+        }
+    }
+    if (out >= 0 && ::close(out) != 0) {
+        ok = false;
+    }
+    ::close(in);
+    return ok;
+}
@@ -0,0 +1,15 @@
+#ifndef LAR_FILE_UTIL_H
+#define LAR_FILE_UTIL_H
+
+#include <string>
+
+// 逐级创建目录（mkdir -p）
+bool make_directories(const std::string& path);
+
+// 路径中最后一个 '/' 之前的部分，没有目录部分时返回空串
+std::string parent_directory(const std::string& path);
+
+// 在内核中复制整个文件（sendfile），不经过用户态缓冲
+bool copy_file(const std::string& from, const std::string& to);
+
+#endif
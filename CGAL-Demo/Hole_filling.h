@@ -0,0 +1,255 @@
+#ifndef LAR_HOLE_FILLING_H
+#define LAR_HOLE_FILLING_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/boost/graph/Euler_operations.h>
+#include <CGAL/boost/graph/iterator.h>
+#include <CGAL/Polygon_mesh_processing/border.h>
+#include <CGAL/Polygon_mesh_processing/fair.h>
+#include <CGAL/Polygon_mesh_processing/refine.h>
+#include <CGAL/Polygon_mesh_processing/triangulate_hole.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// 补洞结果
+struct Hole_filling_report {
+    // 找到的边界环数
+    std::size_t holes = 0;
+    std::size_t filled_holes = 0;
+    // 超过边数上限、只报告不处理的洞
+    std::size_t skipped_holes = 0;
+    // 被跳过的洞中最大的边数
+    std::size_t largest_skipped = 0;
+    // 补片合并失败、退回在网格上直接补洞的洞数
+    std::size_t fallback_holes = 0;
+    std::size_t failed_holes = 0;
+    std::size_t added_faces = 0;
+};
+
+namespace internal_hole_filling {
+
+// 一个洞的补片：角点编号小于边界顶点数时指第 i 个边界顶点，否则指第 i - 边界顶点数 个新顶点
+template <typename Point>
+struct Patch {
+    std::vector<Point> points;
+    std::vector<std::array<std::size_t, 3>> triangles;
+    bool ok = false;
+};
+
+// 在独立的小网格上为一个洞构造补片，只读取原网格，可由多个线程并发执行：
+// 1. 按边界折线三角化，并使补片朝向与边界半边一致
+// 2. 把洞周围一环的原有面一并复制进来，作为光顺时的固定约束，使补片与周围曲面平滑衔接
+// 3. 细化补片并光顺新顶点
+// 边界经过同一顶点两次或三角化失败时返回 false，由调用者退回直接在网格上补洞
+template <typename Point>
+bool build_patch(const CGAL::Surface_mesh<Point>& mesh,
+                 const std::vector<typename CGAL::Surface_mesh<Point>::Vertex_index>& boundary, Patch<Point>& patch) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Face_index Face_index;
+    namespace PMP = CGAL::Polygon_mesh_processing;
+
+    const std::size_t n = boundary.size();
+    std::vector<Vertex_index> sorted(boundary);
+    std::sort(sorted.begin(), sorted.end());
+    if (n < 3 || std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        return false;
+    }
+
+    std::vector<Point> polyline;
+    polyline.reserve(n);
+    for (Vertex_index v : boundary) {
+        polyline.push_back(mesh.point(v));
+    }
+    std::vector<CGAL::Triple<int, int, int>> triples;
+    PMP::triangulate_hole_polyline(polyline, std::back_inserter(triples));
+    if (triples.empty()) {
+        return false;
+    }
+    // 边界半边 i 从顶点 i 指向 i+1，补片上含这条边的三角形必须同向经过它
+    bool reversed = false;
+    for (const auto& t : triples) {
+        const int c[3] = {t.first, t.second, t.third};
+        for (int k = 0; k < 3; ++k) {
+            if (c[k] == 1 && c[(k + 1) % 3] == 0) {
+                reversed = true;
+            }
+        }
+    }
+
+    // 边界顶点最先加入，局部编号与边界序号一致
+    Mesh local;
+    std::unordered_map<Vertex_index, Vertex_index> local_of;
+    for (Vertex_index v : boundary) {
+        local_of.emplace(v, local.add_vertex(mesh.point(v)));
+    }
+    std::vector<Face_index> patch_faces;
+    for (const auto& t : triples) {
+        const Vertex_index a(t.first), b(reversed ? t.third : t.second), c(reversed ? t.second : t.third);
+        const Face_index f = local.add_face(a, b, c);
+        if (f == Mesh::null_face()) {
+            return false;
+        }
+        patch_faces.push_back(f);
+    }
+    std::vector<Face_index> ring;
+    for (Vertex_index v : boundary) {
+        for (Face_index f : CGAL::faces_around_target(mesh.halfedge(v), mesh)) {
+            if (f != Mesh::null_face()) {
+                ring.push_back(f);
+            }
+        }
+    }
+    std::sort(ring.begin(), ring.end());
+    ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+    for (Face_index f : ring) {
+        std::vector<Vertex_index> corners;
+        for (Vertex_index v : CGAL::vertices_around_face(mesh.halfedge(f), mesh)) {
+            auto it = local_of.find(v);
+            if (it == local_of.end()) {
+                it = local_of.emplace(v, local.add_vertex(mesh.point(v))).first;
+            }
+            corners.push_back(it->second);
+        }
+        // 一环内的非流形结构只会让该面无法加入，不影响补片本身
+        local.add_face(corners);
+    }
+
+    std::vector<Face_index> new_faces;
+    std::vector<Vertex_index> new_vertices;
+    PMP::refine(local, patch_faces, std::back_inserter(new_faces), std::back_inserter(new_vertices),
+                PMP::parameters::density_control_factor(std::sqrt(2.0)));
+    if (!new_vertices.empty()) {
+        // 光顺失败时保留细化后的补片
+        PMP::fair(local, new_vertices);
+    }
+
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> index(local.num_vertices(), none);
+    for (std::size_t i = 0; i < n; ++i) {
+        index[i] = i;
+    }
+    for (Vertex_index v : new_vertices) {
+        index[v] = n + patch.points.size();
+        patch.points.push_back(local.point(v));
+    }
+    patch_faces.insert(patch_faces.end(), new_faces.begin(), new_faces.end());
+    for (Face_index f : patch_faces) {
+        std::array<std::size_t, 3> t;
+        int k = 0;
+        for (Vertex_index v : CGAL::vertices_around_face(local.halfedge(f), local)) {
+            if (k == 3 || index[v] == none) {
+                return false;
+            }
+            t[k++] = index[v];
+        }
+        patch.triangles.push_back(t);
+    }
+    patch.ok = true;
+    return true;
+}
+
+} // namespace internal_hole_filling
+
+// 并行补洞：
+// 1. 找出所有边界环并按边数从大到小排序，超过 max_hole_edges 条边的洞只计入报告，不做处理
+// 2. 每个洞作为独立任务动态分配给各线程，大洞先领取，在各自的小网格上三角化、细化与光顺
+// 3. 按排序后的顺序串行把补片并入网格；并入失败的洞撤销已加入的面，再用 CGAL 直接在网格上补洞
+// 补片只依赖原网格与洞本身，合并顺序固定，结果与线程数无关
+template <typename Point>
+Hole_filling_report fill_holes_in_parallel(CGAL::Surface_mesh<Point>& mesh, std::size_t max_hole_edges,
+                                           unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+    typedef typename Mesh::Face_index Face_index;
+    namespace PMP = CGAL::Polygon_mesh_processing;
+
+    Hole_filling_report report;
+    std::vector<Halfedge_index> cycles;
+    PMP::extract_boundary_cycles(mesh, std::back_inserter(cycles));
+    report.holes = cycles.size();
+
+    std::vector<std::vector<Vertex_index>> boundaries(cycles.size());
+    for (std::size_t i = 0; i < cycles.size(); ++i) {
+        for (Halfedge_index h : CGAL::halfedges_around_face(cycles[i], mesh)) {
+            boundaries[i].push_back(mesh.source(h));
+        }
+    }
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < cycles.size(); ++i) {
+        if (boundaries[i].size() > max_hole_edges) {
+            ++report.skipped_holes;
+            report.largest_skipped = std::max(report.largest_skipped, boundaries[i].size());
+        } else {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return boundaries[a].size() > boundaries[b].size(); });
+
+    std::vector<internal_hole_filling::Patch<Point>> patches(cycles.size());
+    parallel_for_dynamic(order.size(), [&](std::size_t i, unsigned) {
+        const std::size_t c = order[i];
+        internal_hole_filling::build_patch(mesh, boundaries[c], patches[c]);
+    }, num_threads);
+
+    for (std::size_t c : order) {
+        internal_hole_filling::Patch<Point>& patch = patches[c];
+        bool merged = patch.ok;
+        if (merged) {
+            std::vector<Vertex_index> vertices(boundaries[c]);
+            for (const Point& p : patch.points) {
+                vertices.push_back(mesh.add_vertex(p));
+            }
+            std::vector<Face_index> added;
+            for (const auto& t : patch.triangles) {
+                const Face_index f = mesh.add_face(vertices[t[0]], vertices[t[1]], vertices[t[2]]);
+                if (f == Mesh::null_face()) {
+                    merged = false;
+                    break;
+                }
+                added.push_back(f);
+            }
+            if (merged) {
+                report.added_faces += added.size();
+            } else {
+                // 撤销已加入的面，随之孤立的新顶点一并删除，洞恢复原状
+                for (Face_index f : added) {
+                    CGAL::Euler::remove_face(mesh.halfedge(f), mesh);
+                }
+                for (std::size_t i = boundaries[c].size(); i < vertices.size(); ++i) {
+                    if (!mesh.is_removed(vertices[i]) && mesh.is_isolated(vertices[i])) {
+                        mesh.remove_vertex(vertices[i]);
+                    }
+                }
+            }
+        }
+        if (!merged) {
+            ++report.fallback_holes;
+            std::vector<Face_index> faces;
+            std::vector<Vertex_index> vertices;
+            if (!mesh.is_border(cycles[c]) ||
+                !std::get<0>(PMP::triangulate_refine_and_fair_hole(mesh, cycles[c], std::back_inserter(faces),
+                                                                   std::back_inserter(vertices)))) {
+                ++report.failed_holes;
+                continue;
+            }
+            report.added_faces += faces.size();
+        }
+        ++report.filled_holes;
+    }
+    return report;
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "Io_ring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+template <typename T>
+T* ring_field(void* ring, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+// 与内核共享的队列指针：读对方推进的一端用 acquire，发布自己推进的一端用 release
+unsigned load_acquire(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+void store_release(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+} // namespace
+
+Io_ring::Io_ring(unsigned entries, bool use_io_uring)
+    : ring_fd_(-1), capacity_(std::max(1u, entries)), in_flight_(0), to_submit_(0),
+      sq_ring_(MAP_FAILED), sq_ring_size_(0), cq_ring_(MAP_FAILED), cq_ring_size_(0), sqes_(MAP_FAILED),
+      sqes_size_(0), sq_head_(nullptr), sq_tail_(nullptr), sq_mask_(0), sq_array_(nullptr), cq_head_(nullptr),
+      cq_tail_(nullptr), cq_mask_(0), cqes_(nullptr) {
+    if (use_io_uring && !setup(capacity_)) {
+        // setup 失败时已释放部分映射，剩下的全部交给同步退路
+        ring_fd_ = -1;
+    }
+}
+
+Io_ring::~Io_ring() {
+    if (sqes_ != MAP_FAILED) {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+        ::munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+        ::close(ring_fd_);
+    }
+}
+
+bool Io_ring::setup(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0) {
+        return false;
+    }
+    // IORING_OP_READ / WRITE 与该特性出自同一内核版本（5.6），以此判断操作码是否可用
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        ::close(fd);
+        return false;
+    }
+    ring_fd_ = fd;
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                    IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    if (cq_ring_ != MAP_FAILED) {
+        sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    }
+    if (cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    sq_head_ = ring_field<unsigned>(sq_ring_, params.sq_off.head);
+    sq_tail_ = ring_field<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = *ring_field<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = ring_field<unsigned>(sq_ring_, params.sq_off.array);
+    cq_head_ = ring_field<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = ring_field<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *ring_field<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = ring_field<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    // 在途请求数不超过提交队列长度，完成队列（默认为其两倍）不会溢出
+    capacity_ = std::min(capacity_, params.sq_entries);
+    return true;
+}
+
+bool Io_ring::read(int fd, void* buffer, unsigned length, std::uint64_t offset, std::uint64_t user_data) {
+    return queue(IORING_OP_READ, fd, reinterpret_cast<std::uintptr_t>(buffer), length, offset, user_data);
+}
+
+bool Io_ring::write(int fd, const void* buffer, unsigned length, std::uint64_t offset, std::uint64_t user_data) {
+    return queue(IORING_OP_WRITE, fd, reinterpret_cast<std::uintptr_t>(buffer), length, offset, user_data);
+}
+
+bool Io_ring::queue(std::uint8_t opcode, int fd, std::uint64_t address, unsigned length, std::uint64_t offset,
+                    std::uint64_t user_data) {
+    if (in_flight_ >= capacity_) {
+        return false;
+    }
+    ++in_flight_;
+    if (!uses_io_uring()) {
+        void* buffer = reinterpret_cast<void*>(static_cast<std::uintptr_t>(address));
+        ssize_t n;
+        do {
+            n = opcode == IORING_OP_READ ? ::pread(fd, buffer, length, static_cast<off_t>(offset))
+                                         : ::pwrite(fd, buffer, length, static_cast<off_t>(offset));
+        } while (n < 0 && errno == EINTR);
+        completed_.push_back({user_data, n < 0 ? -errno : static_cast<int>(n)});
+        return true;
+    }
+
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = address;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    store_release(sq_tail_, tail + 1);
+    ++to_submit_;
+    return true;
+}
+
+bool Io_ring::wait(Io_completion& completion) {
+    if (in_flight_ == 0) {
+        return false;
+    }
+    if (!uses_io_uring()) {
+        completion = completed_.front();
+        completed_.pop_front();
+        --in_flight_;
+        return true;
+    }
+
+    for (;;) {
+        const unsigned head = *cq_head_;
+        const bool ready = head != load_acquire(cq_tail_);
+        if (ready && to_submit_ == 0) {
+            const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes_) + (head & cq_mask_);
+            completion.user_data = cqe->user_data;
+            completion.result = cqe->res;
+            store_release(cq_head_, head + 1);
+            --in_flight_;
+            return true;
+        }
+        // 提交排入的请求；完成队列为空时同时等待至少一个完成
+        int r = sys_io_uring_enter(ring_fd_, to_submit_, ready ? 0 : 1, ready ? 0 : IORING_ENTER_GETEVENTS);
+        if (r < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+            return false;
+        }
+        to_submit_ -= std::min(to_submit_, static_cast<unsigned>(r));
+    }
+}
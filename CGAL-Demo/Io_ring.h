@@ -0,0 +1,68 @@
+#ifndef LAR_IO_RING_H
+#define LAR_IO_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// 一个请求的完成结果：result 为传输的字节数，失败时为 -errno
+struct Io_completion {
+    std::uint64_t user_data;
+    int result;
+};
+
+// 异步文件读写队列，直接通过系统调用使用 io_uring（不依赖 liburing）
+// 内核不支持或被禁用（如容器的 seccomp 策略）时退化为同步 pread/pwrite，接口与完成语义不变
+// 不是线程安全的：每个线程使用自己的实例
+class Io_ring {
+public:
+    // entries 为同时在途的请求数上限；use_io_uring 为 false 时直接使用同步退路
+    explicit Io_ring(unsigned entries = 64, bool use_io_uring = true);
+    ~Io_ring();
+
+    Io_ring(const Io_ring&) = delete;
+    Io_ring& operator=(const Io_ring&) = delete;
+
+    bool uses_io_uring() const { return ring_fd_ >= 0; }
+    // 还能排入的请求数
+    unsigned available() const { return capacity_ - in_flight_; }
+    unsigned in_flight() const { return in_flight_; }
+
+    // 排入一个读/写请求，队列已满时返回 false；请求在下一次 wait 时统一提交
+    bool read(int fd, void* buffer, unsigned length, std::uint64_t offset, std::uint64_t user_data);
+    bool write(int fd, const void* buffer, unsigned length, std::uint64_t offset, std::uint64_t user_data);
+
+    // 提交已排入的请求并取回一个完成结果，必要时阻塞；没有在途请求时返回 false
+    bool wait(Io_completion& completion);
+
+private:
+    bool queue(std::uint8_t opcode, int fd, std::uint64_t address, unsigned length, std::uint64_t offset,
+               std::uint64_t user_data);
+    bool setup(unsigned entries);
+
+    int ring_fd_;
+    unsigned capacity_;
+    unsigned in_flight_;
+    unsigned to_submit_;
+
+    // 映射的提交队列、完成队列与 SQE 数组
+    void* sq_ring_;
+    std::size_t sq_ring_size_;
+    void* cq_ring_;
+    std::size_t cq_ring_size_;
+    void* sqes_;
+    std::size_t sqes_size_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    void* cqes_;
+
+    // 同步退路：请求排入时即执行，完成结果在 wait 时按序取出
+    std::deque<Io_completion> completed_;
+};
+
+#endif
@@ -1,18 +1,76 @@
 #include "LAR_STL.h"
 
-LAR_STL::LAR_STL(const std::string& filename) : is_loaded_and_repaired(false) {
+template <typename Kernel, typename Point>
+Basic_LAR_STL<Kernel, Point>::Basic_LAR_STL(const std::string& filename, const Repair_options& options)
+    : options(options), is_loaded_and_repaired(false) {
     is_loaded_and_repaired = load_and_repair(filename);
 }
 
-LAR_STL::~LAR_STL() {}
+template <typename Kernel, typename Point>
+Basic_LAR_STL<Kernel, Point>::Basic_LAR_STL(STL_soup soup, const Repair_options& options)
+    : options(options), is_loaded_and_repaired(false) {
+    build_from_soup(soup);
+    repair();
+    is_loaded_and_repaired = true;
+}
+
+template <typename Kernel, typename Point>
+Basic_LAR_STL<Kernel, Point>::Basic_LAR_STL(const std::string& filename, const Repair_options& options,
+                                            Mesh&& storage)
+    : mesh(std::move(storage)), options(options), is_loaded_and_repaired(false) {
+    mesh.clear_without_removing_property_maps();
+    is_loaded_and_repaired = load_and_repair(filename);
+}
+
+template <typename Kernel, typename Point>
+Basic_LAR_STL<Kernel, Point>::Basic_LAR_STL(const char* data, std::size_t size, const Repair_options& options)
+    : options(options), is_loaded_and_repaired(false) {
+    is_loaded_and_repaired = load_and_repair(data, size);
+}
+
+template <typename Kernel, typename Point>
+Basic_LAR_STL<Kernel, Point>::~Basic_LAR_STL() {}
 
-const Surface_mesh& LAR_STL::get_repaired_mesh() const {
+template <typename Kernel, typename Point>
+const typename Basic_LAR_STL<Kernel, Point>::Mesh& Basic_LAR_STL<Kernel, Point>::get_repaired_mesh() const {
     return mesh;
 }
 
+template <typename Kernel, typename Point>
+typename Basic_LAR_STL<Kernel, Point>::Mesh Basic_LAR_STL<Kernel, Point>::release_mesh() {
+    is_loaded_and_repaired = false;
+    return std::move(mesh);
+}
+
+template <typename Kernel, typename Point>
+const Stage_profiler& Basic_LAR_STL<Kernel, Point>::get_profile() const {
+    return profiler;
+}
+
+template <typename Kernel, typename Point>
+Mesh_quality Basic_LAR_STL<Kernel, Point>::measure_quality() const {
+    return measure_mesh_quality(mesh, options.num_threads);
+}
+
+template <typename Kernel, typename Point>
+const Mesh_quality& Basic_LAR_STL<Kernel, Point>::get_input_quality() const {
+    return input_quality;
+}
+
+template <typename Kernel, typename Point>
+std::size_t Basic_LAR_STL<Kernel, Point>::get_rejected_facets() const {
+    return rejected_facets;
+}
+
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::stop_stage() const {
+    profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+}
+
 // 移除孤立顶点
-void LAR_STL::remove_isolated_vertices() {
-    std::vector<Surface_mesh::Vertex_index> to_removed; // 修正拼写错误
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::remove_isolated_vertices() {
+    std::vector<typename Mesh::Vertex_index> to_removed; // 修正拼写错误
     for (auto v : mesh.vertices()) {
         if (mesh.is_isolated(v)) {
             to_removed.push_back(v);
@@ -24,92 +82,344 @@ void LAR_STL::remove_isolated_vertices() {
 }
 
 // 流形验证
-bool LAR_STL::is_manifold() {
-    // 检查边是否为流形边（最多关联2个面）
-    for (auto e : mesh.edges()) {
-        std::size_t num_faces = 0;
-        halfedge_descriptor h1 = halfedge(e, mesh);
-        halfedge_descriptor h2 = opposite(h1, mesh);
-        if (is_border(h1, mesh) == false) {
-            ++num_faces;
-        }
-        if (is_border(h2, mesh) == false) {
-            ++num_faces;
-        }
-        if (num_faces > 2) {
-            std::cerr << "非流形边: 边关联了 " << num_faces << " 个面" << std::endl;
-            return false;
-        }
+template <typename Kernel, typename Point>
+bool Basic_LAR_STL<Kernel, Point>::is_manifold() {
+    Manifold_report report = check_manifold();
+    if (!report.non_manifold_edges.empty()) {
+        std::cerr << "非流形边: " << report.non_manifold_edges.size() << " 条边没有关联任何面，首条为 "
+                  << report.non_manifold_edges.front() << std::endl;
     }
-
-    // 检查顶点是否为流形顶点（边构成闭合环路）
-    for (auto v : mesh.vertices()) {
-        if (PMP::is_non_manifold_vertex(v, mesh)) {
-            std::cout << "顶点 " << v << " 是非流形顶点" << std::endl;
-            return false;
-        }
+    if (!report.non_manifold_vertices.empty()) {
+        std::cout << "非流形顶点: " << report.non_manifold_vertices.size() << " 个，首个为 "
+                  << report.non_manifold_vertices.front() << std::endl;
     }
+    return report.is_manifold();
+}
 
-    return true;
+// 流形检查：边与顶点在同一遍并行扫描中完成
+template <typename Kernel, typename Point>
+Manifold_report Basic_LAR_STL<Kernel, Point>::check_manifold() const {
+    return ::check_manifold(mesh, options.num_threads);
 }
 
 // 流形修复
-void LAR_STL::manifold_repair() {
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::manifold_repair() {
     // 复制非流形顶点
-    std::vector<std::vector<Surface_mesh::Vertex_index>> duplicated_vertices;
+    profiler.start("duplicate_non_manifold_vertices");
+    std::vector<std::vector<typename Mesh::Vertex_index>> duplicated_vertices;
     std::size_t new_vertices_nb = PMP::duplicate_non_manifold_vertices(mesh,
                                                                        PMP::parameters::output_iterator(
                                                                            std::back_inserter(duplicated_vertices)));
-    std::cout << new_vertices_nb << " 个顶点已被添加以修复网格流形性" << std::endl;
+    stop_stage();
+    if (options.verbose) {
+        std::cout << new_vertices_nb << " 个顶点已被添加以修复网格流形性" << std::endl;
+    }
 
     // 修复边界
+    profiler.start("stitch_borders");
     PMP::stitch_borders(mesh);
+    stop_stage();
+}
+
+// 按连通分量并行修复
+template <typename Kernel, typename Point>
+bool Basic_LAR_STL<Kernel, Point>::component_repair() {
+    profiler.start("component_repair");
+    Component_repair_report report;
+    const bool split = repair_components_in_parallel(mesh, options.num_threads, report);
+    stop_stage();
+    if (options.verbose) {
+        if (split) {
+            std::cout << report.components << " 个连通分量并行修复：移除 " << report.isolated_vertices
+                      << " 个孤立顶点，添加 " << report.duplicated_vertices << " 个顶点以修复网格流形性" << std::endl;
+        } else {
+            std::cout << report.components << " 个连通分量，改为整体修复" << std::endl;
+        }
+    }
+    return split;
+}
+
+// 自相交修复：AABB 树并行检测相交面对，删除相交区域并细化、光顺补洞
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::self_intersection_repair(std::true_type) {
+    Self_intersection_report report = remove_self_intersections(mesh, options.num_threads, options.max_hole_edges);
+    if (options.verbose && report.intersecting_pairs > 0) {
+        std::cout << report.intersecting_pairs << " 对自相交面，删除 " << report.removed_faces << " 个面后补洞";
+        if (report.unfilled_holes > 0) {
+            std::cout << "，" << report.unfilled_holes << " 个洞补洞失败";
+        }
+        if (report.skipped_holes > 0) {
+            std::cout << "，" << report.skipped_holes << " 个洞超过 " << options.max_hole_edges << " 条边未填补";
+        }
+        std::cout << "，剩余 " << report.remaining_pairs << " 对" << std::endl;
+    }
+}
+
+// 单精度内核的谓词不稳健，检测结果不可信，补洞光顺也需要精确构造，直接跳过
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::self_intersection_repair(std::false_type) {
+    if (options.verbose) {
+        std::cout << "单精度存储模式跳过自相交修复" << std::endl;
+    }
+}
+
+// 补洞：各洞在独立的小网格上并行构造补片，再按洞的大小顺序串行并入
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::hole_filling(std::true_type) {
+    Hole_filling_report report = fill_holes_in_parallel(mesh, options.max_hole_edges, options.num_threads);
+    if (options.verbose && report.holes > 0) {
+        std::cout << report.holes << " 个洞，填补 " << report.filled_holes << " 个，新增 " << report.added_faces
+                  << " 个面";
+        if (report.fallback_holes > 0) {
+            std::cout << "（其中 " << report.fallback_holes << " 个改为直接在网格上补洞）";
+        }
+        if (report.failed_holes > 0) {
+            std::cout << "，" << report.failed_holes << " 个补洞失败";
+        }
+        std::cout << std::endl;
+        if (report.skipped_holes > 0) {
+            std::cout << report.skipped_holes << " 个开口超过 " << options.max_hole_edges << " 条边未填补，最大的有 "
+                      << report.largest_skipped << " 条边" << std::endl;
+        }
+    }
+}
+
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::hole_filling(std::false_type) {
+    if (options.verbose) {
+        std::cout << "单精度存储模式跳过补洞" << std::endl;
+    }
+}
 
-    // 处理自相交（此处可根据实际情况添加更合适的替代方案）
-    // 目前暂时注释掉该功能
-    // PMP::remove_self_intersections(mesh);
+//高级修复
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::advanced_repair(Mesh&mesh){
+    // 缝合微小缝隙（默认阈值0.1mm）：每个连通分量用 k-d 树匹配边界半边，各分量并行
+    const double tolerance = options.stitch_tolerance > 0 ? options.stitch_tolerance : 0.1;
+    Tolerance_stitching_report report = stitch_borders_with_tolerance(mesh, tolerance, options.num_threads);
+    if (options.verbose) {
+        std::cout << report.components << " 个连通分量中按 " << tolerance << " 容差缝合了 " << report.stitched_pairs
+                  << " 对边界半边" << std::endl;
+    }
 }
 
-// //高级修复
-// void LAR_STL::advanced_repair(Surface_mesh&mesh){
-//     // 缝合微小缝隙（阈值0.1mm）
-//     PMP::stitch_borders(mesh,0.1,CGAL::parameters::apply_per_connected_component(true));
-// }
+// 回收垃圾并重排：前面各阶段删除的元素只被标记，重排后索引连续且相邻元素在内存中靠近
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::compact_and_reorder() {
+    if (!reorder_mesh(mesh, options.num_threads)) {
+        // reorder_mesh 已回收垃圾，重建失败时保留原有顺序
+        if (options.verbose) {
+            std::cout << "网格重排失败，保留原有顺序" << std::endl;
+        }
+    }
+}
 
 // 加载并修复 STL 文件
-bool LAR_STL::load_and_repair(const std::string& filename) {
-    std::ifstream input(filename, std::ios::binary);
-    if (!input) {
+template <typename Kernel, typename Point>
+bool Basic_LAR_STL<Kernel, Point>::load_and_repair(const std::string& filename) {
+    Mapped_file file(filename);
+    if (!file.is_open()) {
         std::cerr << "错误：无法打开文件 " << filename << std::endl;
         return false;
     }
+    return load_and_repair(file.data(), file.size());
+}
 
-    if (!CGAL::IO::read_STL(input, mesh)) {
-        std::cerr << "错误：STL 文件解析失败" << std::endl;
-        return false;
+namespace {
+// 只读内存上的流缓冲，供 CGAL 的 ASCII 解析直接读取，不复制文件内容
+class Memory_streambuf : public std::streambuf {
+public:
+    Memory_streambuf(const char* data, std::size_t size) {
+        char* p = const_cast<char*>(data);
+        setg(p, p, p + size);
     }
+};
+} // namespace
 
-    std::cout << "=== 修复前状态 ===" << std::endl;
-    std::cout << "顶点数: " << mesh.num_vertices() << std::endl;
-    std::cout << "面片数: " << mesh.num_faces() << std::endl;
+template <typename Kernel, typename Point>
+bool Basic_LAR_STL<Kernel, Point>::load_and_repair(const char* data, std::size_t size) {
+    Weld_options weld;
+    weld.tolerance = options.weld_tolerance;
+    weld.num_threads = options.num_threads;
+    STL_soup soup;
+    Binary_STL_view view(data, size);
+    std::vector<float> corners;
+    profiler.start("load");
+    if (view.is_valid()) {
+        // 二进制 STL 走快速路径，直接在内存（映射或已读入）上遍历面片记录并多线程焊接顶点
+        weld_binary_STL(view, weld, soup);
+    } else if (parse_ascii_STL(data, size, corners, options.num_threads)) {
+        // ASCII STL 用 SIMD 扫描与 from_chars 分块并行解析，之后与二进制相同
+        weld_STL_corners(corners, weld, soup);
+        std::vector<float>().swap(corners);
+    } else {
+        // 快速解析器不认识的写法（如大写关键字）仍交给 CGAL 解析
+        Memory_streambuf buffer(data, size);
+        std::istream input(&buffer);
+        bool ok = data != nullptr && CGAL::IO::read_STL(input, mesh);
+        stop_stage();
+        if (!ok) {
+            std::cerr << "错误：STL 文件解析失败" << std::endl;
+            return false;
+        }
+        repair();
+        return true;
+    }
+    profiler.stop(soup.points.size(), soup.triangles.size());
 
-    remove_isolated_vertices();
-    manifold_repair();
+    build_from_soup(soup);
+    repair();
+    return true;
+}
 
-    std::cout << "\n=== 修复后状态 ===" << std::endl;
-    std::cout << "有效顶点: " << mesh.num_vertices() << std::endl;
-    std::cout << "有效面片: " << mesh.num_faces() << std::endl;
+// 重复与退化面片在汤上并行剔除，代价远低于让它们进入网格后再由非流形修复与缝合处理
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::build_from_soup(STL_soup& soup) {
+    if (options.remove_duplicate_facets) {
+        profiler.start("soup_cleanup");
+        const Soup_cleanup_report report = clean_STL_soup(soup, options.num_threads);
+        profiler.stop(soup.points.size(), soup.triangles.size());
+        if (options.verbose &&
+            (report.duplicate_facets > 0 || report.degenerate_facets > 0 || report.collapsed_slivers > 0 ||
+             report.split_caps > 0)) {
+            std::cout << "删除 " << report.duplicate_facets << " 个重复面片，" << report.degenerate_facets
+                      << " 个退化面片，塌缩 " << report.collapsed_slivers << " 个针状面片，拆分 " << report.split_caps
+                      << " 个帽状面片" << std::endl;
+        }
+    }
 
-    return true;
-}    
+    // 朝向不一致的面片会在建网格时被拒绝，必须在汤上先统一
+    if (options.orient_facets) {
+        profiler.start("orient_facets");
+        const Soup_orientation_report report = orient_STL_soup(soup, options.num_threads);
+        profiler.stop(soup.points.size(), soup.triangles.size());
+        if (options.verbose && report.flipped_facets > 0) {
+            std::cout << report.components << " 个面片分量中翻转 " << report.flipped_facets << " 个面片，其中 "
+                      << report.inverted_shells << " 个封闭壳体整体翻转为朝外" << std::endl;
+        }
+    }
+
+    profiler.start("build_mesh");
+    rejected_facets = soup_to_mesh(soup, mesh);
+    stop_stage();
+    if (rejected_facets > 0) {
+        if (options.verbose) {
+            std::cout << rejected_facets << " 个面片无法直接加入网格，按多边形汤重建" << std::endl;
+        }
+        profiler.start("rebuild_from_polygon_soup");
+        rejected_facets = rebuild_from_polygon_soup(soup);
+        stop_stage();
+    }
+    if (rejected_facets > 0 && options.verbose) {
+        std::cout << rejected_facets << " 个退化或非流形面片在建网格时被丢弃" << std::endl;
+    }
+}
+
+// 同一条边上的第三个面片、无法解开的非流形扇面会被 add_face 拒绝：
+// orient_polygon_soup 统一朝向并复制非流形顶点与边，之后整个汤可以无损地转成网格，
+// 复制出的顶点与边界留给后续的流形修复与边界缝合处理；只有编号退化的面片被丢弃
+template <typename Kernel, typename Point>
+std::size_t Basic_LAR_STL<Kernel, Point>::rebuild_from_polygon_soup(const STL_soup& soup) {
+    namespace PMP = CGAL::Polygon_mesh_processing;
+    std::vector<Point> points;
+    points.reserve(soup.points.size());
+    for (const auto& p : soup.points) {
+        points.push_back(Point(p[0], p[1], p[2]));
+    }
+    std::vector<std::array<std::size_t, 3>> polygons;
+    polygons.reserve(soup.triangles.size());
+    for (const auto& t : soup.triangles) {
+        if (t[0] != t[1] && t[1] != t[2] && t[0] != t[2]) {
+            polygons.push_back({{t[0], t[1], t[2]}});
+        }
+    }
+    PMP::orient_polygon_soup(points, polygons);
+
+    mesh.clear_without_removing_property_maps();
+    if (PMP::is_polygon_soup_a_polygon_mesh(polygons)) {
+        PMP::polygon_soup_to_polygon_mesh(points, polygons, mesh);
+    } else {
+        // 重复面片等 orient_polygon_soup 无法处理的情形：逐面加入，仍被拒绝的面片计入丢弃数
+        std::vector<typename Mesh::Vertex_index> vertices;
+        vertices.reserve(points.size());
+        for (const Point& p : points) {
+            vertices.push_back(mesh.add_vertex(p));
+        }
+        for (const auto& t : polygons) {
+            mesh.add_face(vertices[t[0]], vertices[t[1]], vertices[t[2]]);
+        }
+    }
+    return soup.triangles.size() - mesh.number_of_faces();
+}
+
+// 依次执行各修复阶段
+template <typename Kernel, typename Point>
+void Basic_LAR_STL<Kernel, Point>::repair() {
+    if (options.measure_input_quality) {
+        profiler.start("input_quality");
+        input_quality = measure_quality();
+        stop_stage();
+    }
+    if (options.verbose) {
+        std::cout << "=== 修复前状态 ===" << std::endl;
+        std::cout << "顶点数: " << mesh.num_vertices() << std::endl;
+        std::cout << "面片数: " << mesh.num_faces() << std::endl;
+    }
+
+    if (!options.repair_by_component || !component_repair()) {
+        profiler.start("remove_isolated_vertices");
+        remove_isolated_vertices();
+        stop_stage();
+        manifold_repair();
+    }
+    // 自相交可能发生在不同分量之间，始终在整体网格上处理
+    if (options.repair_self_intersections) {
+        profiler.start("self_intersection_repair");
+        self_intersection_repair(Supports_robust_repair<Kernel>());
+        stop_stage();
+    }
+    if (options.stitch_tolerance > 0) {
+        profiler.start("advanced_repair");
+        advanced_repair(mesh);
+        stop_stage();
+    }
+    // 所有缝合完成后剩下的边界环才是真正的洞
+    if (options.fill_holes) {
+        profiler.start("fill_holes");
+        hole_filling(Supports_robust_repair<Kernel>());
+        stop_stage();
+    }
+    if (options.reorder_for_locality) {
+        profiler.start("compact_and_reorder");
+        compact_and_reorder();
+        stop_stage();
+    }
+
+    if (options.verbose) {
+        std::cout << "\n=== 修复后状态 ===" << std::endl;
+        std::cout << "有效顶点: " << mesh.num_vertices() << std::endl;
+        std::cout << "有效面片: " << mesh.num_faces() << std::endl;
+    }
+}
 
 // 保存修复后的网格到文件
-bool LAR_STL::save_repaired_mesh(const std::string& outfilename) const {
-    if (CGAL::IO::write_STL(outfilename, mesh)) {
-        std::cout << "\n修复结果已保存至：" << outfilename << std::endl;
+template <typename Kernel, typename Point>
+bool Basic_LAR_STL<Kernel, Point>::save_repaired_mesh(const std::string& outfilename) const {
+    profiler.start("write");
+    // 并行计算法向并直接写入预设大小的映射文件，不再逐面片经由流输出
+    const bool ok = write_binary_STL(outfilename, mesh, options.num_threads);
+    stop_stage();
+    if (ok) {
+        if (options.verbose) {
+            std::cout << "\n修复结果已保存至：" << outfilename << std::endl;
+        }
         return true;
     } else {
         std::cerr << "保存文件 " << outfilename << " 失败。" << std::endl;
         return false;
      }
-}
\ No newline at end of file
+}
+
+template class Basic_LAR_STL<K>;
+template class Basic_LAR_STL<Kf>;
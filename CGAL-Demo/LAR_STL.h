@@ -2,13 +2,30 @@
 #define LOAD_AND_REPAIR_STL
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Simple_cartesian.h>
 #include <CGAL/Surface_mesh.h>
 #include <CGAL/IO/STL.h>
 #include <CGAL/Polygon_mesh_processing/repair.h>
 #include <CGAL/Polygon_mesh_processing/stitch_borders.h> 
 #include <CGAL/Polygon_mesh_processing/IO/polygon_mesh_io.h>
+#include <CGAL/Polygon_mesh_processing/orient_polygon_soup.h>
+#include <CGAL/Polygon_mesh_processing/polygon_soup_to_polygon_mesh.h>
 #include <CGAL/boost/graph/iterator.h> 
+#include "STL_reader.h"
+#include "STL_writer.h"
+#include "Vertex_welder.h"
+#include "Soup_cleanup.h"
+#include "Soup_orientation.h"
+#include "Manifold_check.h"
+#include "Self_intersection.h"
+#include "Tolerance_stitching.h"
+#include "Hole_filling.h"
+#include "Component_repair.h"
+#include "Mesh_reorder.h"
+#include "Stage_profiler.h"
+#include "Mesh_quality.h"
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 // 定义核心的几何内核（相当于数学计算的基础引擎）
@@ -17,32 +34,125 @@ typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
 typedef CGAL::Surface_mesh<K::Point_3> Surface_mesh;
 typedef boost::graph_traits<Surface_mesh>::edge_descriptor edge_descriptor;
 typedef boost::graph_traits<Surface_mesh>::halfedge_descriptor halfedge_descriptor;
+// 单精度内核：STL 坐标本身只有 float32 精度，点坐标内存与带宽减半
+typedef CGAL::Simple_cartesian<float> Kf;
+typedef CGAL::Surface_mesh<Kf::Point_3> Surface_mesh_float;
 
 namespace PMP = CGAL::Polygon_mesh_processing;
 
-class LAR_STL {
+// 修复参数
+struct Repair_options {
+    // 顶点焊接容差：0 表示只合并坐标完全相同的点
+    double weld_tolerance = 0.0;
+    // 并行阶段使用的线程数，0 表示使用全部硬件线程
+    unsigned num_threads = 0;
+    // 容差缝合阈值（毫米），大于 0 时在流形修复后执行高级修复
+    double stitch_tolerance = 0.0;
+    // 建网格前在三角形汤上删除重复面片（顶点集合相同，不论朝向）与焊接后塌缩的退化面片
+    bool remove_duplicate_facets = true;
+    // 建网格前沿流形边传播统一面片朝向，封闭壳体按有向体积翻转为朝外
+    bool orient_facets = true;
+    // 按连通分量拆成子网格并行执行孤立顶点移除、非流形顶点复制与边界缝合，再按分量顺序合并，
+    // 适合由大量独立壳体组成的装配体；结果与线程数无关
+    bool repair_by_component = false;
+    // 是否检测并修复自相交（AABB 树加速，删除相交区域后补洞）
+    bool repair_self_intersections = true;
+    // 缝合之后仍然存在的边界环按洞并行三角化、细化与光顺，使输出封闭
+    bool fill_holes = true;
+    // 边数超过该值的开口只报告、不填补，避免把模型本身的大开口补上
+    std::size_t max_hole_edges = 1000;
+    // 修复结束后回收已删除元素，并按 Morton 序重排顶点与面以改善缓存局部性
+    bool reorder_for_locality = true;
+    // 修复前先统计一次输入网格的质量，供修复前后对比
+    bool measure_input_quality = false;
+    // 是否在控制台输出各阶段信息
+    bool verbose = true;
+};
+
+// 内核能否承担需要稳健谓词与构造的阶段（自相交检测、补洞细化与光顺）
+// 单精度内核的谓词不稳健，这些阶段在该内核上被跳过，其余纯组合或只比较坐标的阶段照常执行
+template <typename Kernel>
+struct Supports_robust_repair : std::true_type {};
+template <>
+struct Supports_robust_repair<Kf> : std::false_type {};
+
+// 修复流程，按内核与点类型模板化；成员定义在 LAR_STL.cpp 中，并对 K 与 Kf 显式实例化
+template <typename Kernel, typename Point = typename Kernel::Point_3>
+class Basic_LAR_STL {
 public:
+    typedef CGAL::Surface_mesh<Point> Mesh;
+
     // 负责加载和修复 STL 文件
-    LAR_STL(const std::string& filename);
-    ~LAR_STL();
+    Basic_LAR_STL(const std::string& filename, const Repair_options& options = Repair_options());
+    // 由已焊接的三角形汤建网格并修复（流式修复的分块使用）；汤会先被清理，按值传入以便调用者移交
+    Basic_LAR_STL(STL_soup soup, const Repair_options& options = Repair_options());
+    // 复用调用者的网格存储加载并修复（常驻服务用）：storage 的内容被清空，已分配的容量保留
+    Basic_LAR_STL(const std::string& filename, const Repair_options& options, Mesh&& storage);
+    // 从内存中的 STL 文件内容加载并修复（流水线批处理用，读文件由调用者异步完成）
+    Basic_LAR_STL(const char* data, std::size_t size, const Repair_options& options = Repair_options());
+    ~Basic_LAR_STL();
 
     // 获取修复后的网格
-    const Surface_mesh& get_repaired_mesh() const;
+    const Mesh& get_repaired_mesh() const;
+    // 交出网格存储，供下一个任务通过上面的构造函数复用
+    Mesh release_mesh();
     // 保存修复后的网格到文件
     bool save_repaired_mesh(const std::string& outfilename) const;
     // 流形验证
     bool is_manifold();
-    // 高级修复
-    void advanced_repair(Surface_mesh&mesh);
+    // 并行单遍流形检查，返回所有非流形边与顶点的索引
+    Manifold_report check_manifold() const;
+    // 高级修复：按连通分量并行做容差缝合
+    void advanced_repair(Mesh&mesh);
+    // 各阶段（加载、建网格、各修复步骤、写出）的耗时、内存与元素数量
+    const Stage_profiler& get_profile() const;
+    // 单遍并行统计当前网格的质量（面积、纵横比、最小角、退化面、包围盒、边长直方图、边界边）
+    Mesh_quality measure_quality() const;
+    // 修复前输入网格的质量，仅在 measure_input_quality 开启时有效
+    const Mesh_quality& get_input_quality() const;
+    // 建网格时最终未能加入网格而被丢弃的面片数（含编号退化的面片）
+    std::size_t get_rejected_facets() const;
 private:
-    Surface_mesh mesh;
+    Mesh mesh;
+    Repair_options options;
     bool is_loaded_and_repaired;
+    // save_repaired_mesh 为 const 成员，写出阶段同样需要计量
+    mutable Stage_profiler profiler;
+    Mesh_quality input_quality;
+    std::size_t rejected_facets = 0;
 
     // 移除孤立顶点
     void remove_isolated_vertices();
     // 加载并修复 STL 文件
     bool load_and_repair(const std::string& filename);
-    // 流形修复
+    bool load_and_repair(const char* data, std::size_t size);
+    // 清理并定向三角形汤，再由其建网格
+    void build_from_soup(STL_soup& soup);
+    // add_face 拒绝了部分面片时改走多边形汤流程重建网格，返回仍被丢弃的面片数
+    std::size_t rebuild_from_polygon_soup(const STL_soup& soup);
+    // 对已加载的网格依次执行各修复阶段
+    void repair();
+    // 流形修复：复制非流形顶点并缝合边界
     void manifold_repair();
+    // 按分量并行完成孤立顶点移除与流形修复；无法按分量拆分时返回 false
+    bool component_repair();
+    // 自相交修复：按内核能力分派，单精度内核上为空操作
+    void self_intersection_repair(std::true_type);
+    void self_intersection_repair(std::false_type);
+    // 补洞：同样需要稳健构造，单精度内核上为空操作
+    void hole_filling(std::true_type);
+    void hole_filling(std::false_type);
+    // 回收垃圾并按空间局部性重排
+    void compact_and_reorder();
+    // 结束当前计量阶段，记录此时网格的顶点与面数
+    void stop_stage() const;
 };
+
+extern template class Basic_LAR_STL<K>;
+extern template class Basic_LAR_STL<Kf>;
+
+// 默认的双精度修复流程
+typedef Basic_LAR_STL<K> LAR_STL;
+// 单精度存储的修复流程，用于超大网格；不做自相交修复
+typedef Basic_LAR_STL<Kf> LAR_STL_float;
 #endif    
\ No newline at end of file
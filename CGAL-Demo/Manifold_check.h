@@ -0,0 +1,78 @@
+#ifndef LAR_MANIFOLD_CHECK_H
+#define LAR_MANIFOLD_CHECK_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/Polygon_mesh_processing/repair.h>
+
+#include <algorithm>
+#include <vector>
+
+// 流形检查报告：列出所有缺陷元素的索引，而不是遇到第一个就返回
+struct Manifold_report {
+    // 没有任何关联面的悬空边（半边结构中无法出现关联 2 个以上面的边，悬空边是唯一的边缺陷）
+    std::vector<std::size_t> non_manifold_edges;
+    // 周围存在多个边界扇区的非流形顶点
+    std::vector<std::size_t> non_manifold_vertices;
+    // 边界边数量（不算缺陷，便于判断是否水密）
+    std::size_t border_edges = 0;
+
+    bool is_manifold() const { return non_manifold_edges.empty() && non_manifold_vertices.empty(); }
+};
+
+// 单遍并行流形检查：把边与顶点的原始索引区间按块分给各线程，
+// 每块同时检查该区间内的边和顶点，已删除的元素跳过，结果按索引有序
+template <typename Point>
+Manifold_report check_manifold(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Edge_index Edge_index;
+
+    const std::size_t ne = mesh.num_edges();
+    const std::size_t nv = mesh.num_vertices();
+    const std::size_t n = std::max(ne, nv);
+    const unsigned chunks = parallel_chunk_count(n, num_threads);
+
+    struct Local {
+        std::vector<std::size_t> edges;
+        std::vector<std::size_t> vertices;
+        std::size_t border = 0;
+    };
+    std::vector<Local> local(chunks);
+
+    parallel_for(n, [&](std::size_t b, std::size_t e, unsigned t) {
+        Local& out = local[t];
+        for (std::size_t i = b; i < e; ++i) {
+            if (i < ne) {
+                Edge_index ed(static_cast<typename Mesh::size_type>(i));
+                if (!mesh.is_removed(ed)) {
+                    const bool b0 = mesh.is_border(mesh.halfedge(ed, 0));
+                    const bool b1 = mesh.is_border(mesh.halfedge(ed, 1));
+                    if (b0 && b1) {
+                        out.edges.push_back(i);
+                    } else if (b0 || b1) {
+                        ++out.border;
+                    }
+                }
+            }
+            if (i < nv) {
+                Vertex_index v(static_cast<typename Mesh::size_type>(i));
+                if (!mesh.is_removed(v) && !mesh.is_isolated(v) &&
+                    CGAL::Polygon_mesh_processing::is_non_manifold_vertex(v, mesh)) {
+                    out.vertices.push_back(i);
+                }
+            }
+        }
+    }, num_threads);
+
+    Manifold_report report;
+    for (const Local& l : local) {
+        report.non_manifold_edges.insert(report.non_manifold_edges.end(), l.edges.begin(), l.edges.end());
+        report.non_manifold_vertices.insert(report.non_manifold_vertices.end(), l.vertices.begin(), l.vertices.end());
+        report.border_edges += l.border;
+    }
+    return report;
+}
+
+#endif
@@ -0,0 +1,193 @@
+#include "Mesh_quality.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const double degenerate_ratio = 1e-12;
+
+// 面 i 的两倍面积与三条边长
+void scalar_metrics(const Quality_block& b, std::size_t i, double* twice_area, double* length[3]) {
+    double edge[3][3];
+    for (int k = 0; k < 3; ++k) {
+        for (int c = 0; c < 3; ++c) {
+            edge[k][c] = b.corner[c][(k + 1) % 3][i] - b.corner[c][k][i];
+        }
+        length[k][i] = std::sqrt(edge[k][0] * edge[k][0] + edge[k][1] * edge[k][1] + edge[k][2] * edge[k][2]);
+    }
+    const double* u = edge[0];
+    const double v[3] = {-edge[2][0], -edge[2][1], -edge[2][2]};
+    const double n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+    twice_area[i] = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+}
+
+int histogram_bin(double length) {
+    if (!(length > 0.0)) {
+        return 0;
+    }
+    int exponent;
+    std::frexp(length, &exponent);
+    // length = m * 2^exponent，m ∈ [0.5, 1)，所以 floor(log2(length)) = exponent - 1
+    const int bin = exponent - 1 - Mesh_quality::histogram_min_exponent;
+    return std::max(0, std::min(Mesh_quality::histogram_bins - 1, bin));
+}
+
+} // namespace
+
+void Quality_accumulator::add(const Quality_block& b) {
+    const std::size_t n = b.size;
+    double twice_area[Quality_block::capacity];
+    double len[3][Quality_block::capacity];
+    double* length[3] = {len[0], len[1], len[2]};
+
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    // 每次两个面：边向量、叉积与四次开方都成组计算
+    for (; i + 2 <= n; i += 2) {
+        __m128d p[3][3];
+        for (int k = 0; k < 3; ++k) {
+            for (int c = 0; c < 3; ++c) {
+                p[k][c] = _mm_loadu_pd(&b.corner[c][k][i]);
+            }
+        }
+        __m128d e[3][3];
+        for (int k = 0; k < 3; ++k) {
+            for (int c = 0; c < 3; ++c) {
+                e[k][c] = _mm_sub_pd(p[(k + 1) % 3][c], p[k][c]);
+            }
+            const __m128d l2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(e[k][0], e[k][0]), _mm_mul_pd(e[k][1], e[k][1])),
+                                          _mm_mul_pd(e[k][2], e[k][2]));
+            _mm_storeu_pd(&len[k][i], _mm_sqrt_pd(l2));
+        }
+        // 角点 0 处的两条边：e0 与 -e2，叉积 e0 × (-e2) = e2 × e0
+        const __m128d* u = e[2];
+        const __m128d* v = e[0];
+        const __m128d nx = _mm_sub_pd(_mm_mul_pd(u[1], v[2]), _mm_mul_pd(u[2], v[1]));
+        const __m128d ny = _mm_sub_pd(_mm_mul_pd(u[2], v[0]), _mm_mul_pd(u[0], v[2]));
+        const __m128d nz = _mm_sub_pd(_mm_mul_pd(u[0], v[1]), _mm_mul_pd(u[1], v[0]));
+        const __m128d n2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, nx), _mm_mul_pd(ny, ny)), _mm_mul_pd(nz, nz));
+        _mm_storeu_pd(&twice_area[i], _mm_sqrt_pd(n2));
+    }
+#endif
+    for (; i < n; ++i) {
+        scalar_metrics(b, i, twice_area, length);
+    }
+
+    if (n > 0 && q_.faces == 0) {
+        q_.min_area = std::numeric_limits<double>::infinity();
+        q_.min_edge_length = std::numeric_limits<double>::infinity();
+        for (int c = 0; c < 3; ++c) {
+            q_.bbox_min[c] = std::numeric_limits<double>::infinity();
+            q_.bbox_max[c] = -std::numeric_limits<double>::infinity();
+        }
+    }
+    const double aspect_scale = 1.0 / (4.0 * std::sqrt(3.0));
+    for (i = 0; i < n; ++i) {
+        const double l0 = len[0][i], l1 = len[1][i], l2 = len[2][i];
+        const double lmax = std::max(l0, std::max(l1, l2));
+        const double lmin = std::min(l0, std::min(l1, l2));
+        const double area = 0.5 * twice_area[i];
+        q_.total_area += area;
+        q_.min_area = std::min(q_.min_area, area);
+        q_.max_area = std::max(q_.max_area, area);
+        if (twice_area[i] <= degenerate_ratio * lmax * lmax) {
+            ++q_.degenerate_faces;
+        } else {
+            // 最小内角对着最短边：sin = 2A / (两条较长边之积) = 2A × lmin / (l0 l1 l2)
+            min_sine_ = std::min(min_sine_, twice_area[i] * lmin / (l0 * l1 * l2));
+            const double aspect = lmax * (l0 + l1 + l2) * aspect_scale / area;
+            q_.max_aspect_ratio = std::max(q_.max_aspect_ratio, aspect);
+            aspect_sum_ += aspect;
+            ++regular_faces_;
+        }
+        for (int k = 0; k < 3; ++k) {
+            if (b.owned_edges[i] & (1u << k)) {
+                const double l = len[k][i];
+                ++q_.edges;
+                edge_length_sum_ += l;
+                q_.min_edge_length = std::min(q_.min_edge_length, l);
+                q_.max_edge_length = std::max(q_.max_edge_length, l);
+                ++q_.edge_length_histogram[histogram_bin(l)];
+            }
+            for (int c = 0; c < 3; ++c) {
+                q_.bbox_min[c] = std::min(q_.bbox_min[c], b.corner[c][k][i]);
+                q_.bbox_max[c] = std::max(q_.bbox_max[c], b.corner[c][k][i]);
+            }
+        }
+    }
+    q_.faces += n;
+    q_.border_edges += b.border_edges;
+}
+
+void Quality_accumulator::merge(const Quality_accumulator& o) {
+    if (o.q_.faces == 0) {
+        return;
+    }
+    if (q_.faces == 0) {
+        *this = o;
+        return;
+    }
+    q_.faces += o.q_.faces;
+    q_.degenerate_faces += o.q_.degenerate_faces;
+    q_.edges += o.q_.edges;
+    q_.border_edges += o.q_.border_edges;
+    q_.total_area += o.q_.total_area;
+    q_.min_area = std::min(q_.min_area, o.q_.min_area);
+    q_.max_area = std::max(q_.max_area, o.q_.max_area);
+    q_.max_aspect_ratio = std::max(q_.max_aspect_ratio, o.q_.max_aspect_ratio);
+    q_.min_edge_length = std::min(q_.min_edge_length, o.q_.min_edge_length);
+    q_.max_edge_length = std::max(q_.max_edge_length, o.q_.max_edge_length);
+    for (int c = 0; c < 3; ++c) {
+        q_.bbox_min[c] = std::min(q_.bbox_min[c], o.q_.bbox_min[c]);
+        q_.bbox_max[c] = std::max(q_.bbox_max[c], o.q_.bbox_max[c]);
+    }
+    for (int k = 0; k < Mesh_quality::histogram_bins; ++k) {
+        q_.edge_length_histogram[k] += o.q_.edge_length_histogram[k];
+    }
+    aspect_sum_ += o.aspect_sum_;
+    edge_length_sum_ += o.edge_length_sum_;
+    min_sine_ = std::min(min_sine_, o.min_sine_);
+    regular_faces_ += o.regular_faces_;
+}
+
+Mesh_quality Quality_accumulator::result() const {
+    Mesh_quality q = q_;
+    if (q.faces == 0) {
+        return Mesh_quality();
+    }
+    q.mean_aspect_ratio = regular_faces_ > 0 ? aspect_sum_ / regular_faces_ : 0.0;
+    q.mean_edge_length = q.edges > 0 ? edge_length_sum_ / q.edges : 0.0;
+    if (q.edges == 0) {
+        q.min_edge_length = 0.0;
+    }
+    q.min_angle = regular_faces_ > 0 ? std::asin(std::min(1.0, min_sine_)) * 180.0 / M_PI : 0.0;
+    return q;
+}
+
+void Mesh_quality::write_json(std::ostream& os) const {
+    os << "{\"faces\": " << faces << ", \"degenerate_faces\": " << degenerate_faces << ", \"edges\": " << edges
+       << ", \"border_edges\": " << border_edges << ", \"total_area\": " << total_area << ", \"min_area\": " << min_area
+       << ", \"max_area\": " << max_area << ", \"min_angle\": " << min_angle
+       << ", \"max_aspect_ratio\": " << max_aspect_ratio << ", \"mean_aspect_ratio\": " << mean_aspect_ratio
+       << ", \"min_edge_length\": " << min_edge_length << ", \"max_edge_length\": " << max_edge_length
+       << ", \"mean_edge_length\": " << mean_edge_length << ", \"bbox_min\": [" << bbox_min[0] << ", "
+       << bbox_min[1] << ", " << bbox_min[2] << "], \"bbox_max\": [" << bbox_max[0] << ", " << bbox_max[1] << ", "
+       << bbox_max[2] << "], \"edge_length_histogram\": [";
+    bool first = true;
+    for (int k = 0; k < histogram_bins; ++k) {
+        if (edge_length_histogram[k] == 0) {
+            continue;
+        }
+        os << (first ? "" : ", ") << "{\"min\": " << std::ldexp(1.0, k + histogram_min_exponent)
+           << ", \"count\": " << edge_length_histogram[k] << "}";
+        first = false;
+    }
+    os << "]}";
+}
@@ -0,0 +1,128 @@
+#ifndef LAR_MESH_QUALITY_H
+#define LAR_MESH_QUALITY_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+// 三角网格质量统计
+struct Mesh_quality {
+    // 边长直方图：第 i 格统计长度在 [2^(i + histogram_min_exponent), 2^(i + 1 + histogram_min_exponent)) 的边，
+    // 首末两格同时收纳超出范围的边（含零长度边）
+    static constexpr int histogram_min_exponent = -16;
+    static constexpr int histogram_bins = 32;
+
+    std::size_t faces = 0;
+    // 两倍面积不超过最长边平方的 1e-12 倍的面
+    std::size_t degenerate_faces = 0;
+    std::size_t edges = 0;
+    std::size_t border_edges = 0;
+    double total_area = 0.0;
+    double min_area = 0.0;
+    double max_area = 0.0;
+    // 非退化面的最小内角（度）
+    double min_angle = 0.0;
+    // 纵横比：最长边 × 周长 / (4√3 × 面积)，正三角形为 1；只统计非退化面
+    double max_aspect_ratio = 0.0;
+    double mean_aspect_ratio = 0.0;
+    double min_edge_length = 0.0;
+    double max_edge_length = 0.0;
+    double mean_edge_length = 0.0;
+    std::array<double, 3> bbox_min = {{0.0, 0.0, 0.0}};
+    std::array<double, 3> bbox_max = {{0.0, 0.0, 0.0}};
+    std::array<std::size_t, histogram_bins> edge_length_histogram = {};
+
+    // 输出 JSON 对象，直方图只列出非空的格子
+    void write_json(std::ostream& os) const;
+};
+
+// 一块面片的角点坐标（按分量分开存放，便于 SIMD 成组计算）与边的归属
+struct Quality_block {
+    static constexpr std::size_t capacity = 1024;
+    std::size_t size = 0;
+    // corner[c][k][i]：第 i 个面第 k 个角点的第 c 个坐标分量
+    double corner[3][3][capacity];
+    // 第 j 位为 1 表示该面的第 j 条边（角点 j 到 j+1）由本面计数，每条边只被计数一次
+    unsigned char owned_edges[capacity];
+    std::size_t border_edges = 0;
+};
+
+// 分块累加的中间结果，按块序合并，结果与线程数无关
+class Quality_accumulator {
+public:
+    // 用 SSE2 每次计算两个面的面积与边长，再归约到各项统计
+    void add(const Quality_block& block);
+    void merge(const Quality_accumulator& other);
+    Mesh_quality result() const;
+
+private:
+    Mesh_quality q_;
+    double aspect_sum_ = 0.0;
+    double edge_length_sum_ = 0.0;
+    // 最小内角的正弦，最后统一换算成角度
+    double min_sine_ = 1.0;
+    std::size_t regular_faces_ = 0;
+};
+
+// 单遍并行统计网格质量：面按固定大小分块，各块在线程间动态分配；
+// 每块先沿半边收集角点与边的归属，再成组计算面积、纵横比、最小角、边长直方图与包围盒
+template <typename Point>
+Mesh_quality measure_mesh_quality(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Face_index Face_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+
+    const std::size_t nf = mesh.num_faces();
+    const std::size_t nb = (nf + Quality_block::capacity - 1) / Quality_block::capacity;
+    std::vector<Quality_accumulator> partial(nb);
+    const unsigned chunks = parallel_chunk_count(nb, num_threads, 1);
+    std::vector<std::unique_ptr<Quality_block>> blocks(chunks);
+
+    parallel_for_dynamic(nb, [&](std::size_t b, unsigned t) {
+        if (!blocks[t]) {
+            blocks[t].reset(new Quality_block());
+        }
+        Quality_block& block = *blocks[t];
+        block.size = 0;
+        block.border_edges = 0;
+        const std::size_t end = std::min(nf, (b + 1) * Quality_block::capacity);
+        for (std::size_t i = b * Quality_block::capacity; i < end; ++i) {
+            const Face_index f(static_cast<typename Mesh::size_type>(i));
+            if (mesh.is_removed(f)) {
+                continue;
+            }
+            const std::size_t s = block.size++;
+            // 网格由三角形组成：角点 k 为第 k 条半边的起点
+            Halfedge_index h = mesh.halfedge(f);
+            unsigned char owned = 0;
+            for (int k = 0; k < 3; ++k) {
+                const Point& p = mesh.point(mesh.source(h));
+                block.corner[0][k][s] = CGAL::to_double(p.x());
+                block.corner[1][k][s] = CGAL::to_double(p.y());
+                block.corner[2][k][s] = CGAL::to_double(p.z());
+                const Halfedge_index opposite = mesh.opposite(h);
+                const bool border = mesh.is_border(opposite);
+                block.border_edges += border;
+                if (border || h.idx() < opposite.idx()) {
+                    owned |= static_cast<unsigned char>(1u << k);
+                }
+                h = mesh.next(h);
+            }
+            block.owned_edges[s] = owned;
+        }
+        partial[b].add(block);
+    }, num_threads);
+
+    Quality_accumulator total;
+    for (const Quality_accumulator& p : partial) {
+        total.merge(p);
+    }
+    return total.result();
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef LAR_MESH_REORDER_H
+#define LAR_MESH_REORDER_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace internal_reorder {
+
+// 把 21 位整数的各位间隔两位展开，用于拼出 63 位 Morton 码
+inline std::uint64_t spread_bits(std::uint64_t x) {
+    x &= 0x1FFFFF;
+    x = (x | (x << 32)) & 0x1F00000000FFFFull;
+    x = (x | (x << 16)) & 0x1F0000FF0000FFull;
+    x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+    x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+    x = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+}
+
+inline std::uint64_t morton_code(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+    return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+}
+
+} // namespace internal_reorder
+
+// 回收垃圾并按空间填充曲线重排网格，使后续邻域遍历尽量顺序访问内存：
+// 1. collect_garbage 去掉 remove_vertex / remove_face 留下的空洞
+// 2. 顶点按 Morton 码（Z 序曲线）排序，编码并行计算、并行排序
+// 3. 面按其最小新顶点编号排序，半边随面的插入顺序连续分配
+// 重建时只保留顶点坐标，其余属性表不会被复制；若重建失败则保持原网格不变
+template <typename Point>
+bool reorder_mesh(CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Face_index Face_index;
+    typedef typename Mesh::size_type size_type;
+
+    mesh.collect_garbage();
+    const std::size_t nv = mesh.number_of_vertices();
+    const std::size_t nf = mesh.number_of_faces();
+    if (nv == 0) {
+        return true;
+    }
+
+    // 包围盒
+    double lo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                    std::numeric_limits<double>::max()};
+    double hi[3] = {-lo[0], -lo[1], -lo[2]};
+    for (Vertex_index v : mesh.vertices()) {
+        const Point& p = mesh.point(v);
+        for (int i = 0; i < 3; ++i) {
+            const double c = CGAL::to_double(p[i]);
+            lo[i] = std::min(lo[i], c);
+            hi[i] = std::max(hi[i], c);
+        }
+    }
+    double scale[3];
+    for (int i = 0; i < 3; ++i) {
+        scale[i] = hi[i] > lo[i] ? double((1u << 21) - 1) / (hi[i] - lo[i]) : 0.0;
+    }
+
+    // collect_garbage 之后顶点索引连续，可直接按下标并行计算
+    std::vector<std::pair<std::uint64_t, size_type>> keys(nv);
+    parallel_for(nv, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) {
+            const Point& p = mesh.point(Vertex_index(static_cast<size_type>(i)));
+            std::uint32_t q[3];
+            for (int k = 0; k < 3; ++k) {
+                q[k] = static_cast<std::uint32_t>((CGAL::to_double(p[k]) - lo[k]) * scale[k]);
+            }
+            keys[i] = std::make_pair(internal_reorder::morton_code(q[0], q[1], q[2]), static_cast<size_type>(i));
+        }
+    }, num_threads);
+    parallel_sort(keys.begin(), keys.end(), std::less<std::pair<std::uint64_t, size_type>>(), num_threads);
+
+    std::vector<size_type> new_index(nv);
+    for (std::size_t i = 0; i < nv; ++i) {
+        new_index[keys[i].second] = static_cast<size_type>(i);
+    }
+
+    // 面按三个新顶点编号（保持环绕方向，从最小者开始）排序
+    typedef std::array<size_type, 3> Triangle;
+    std::vector<Triangle> triangles(nf);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) {
+            auto h = mesh.halfedge(Face_index(static_cast<size_type>(i)));
+            Triangle t = {{new_index[mesh.source(h)], new_index[mesh.target(h)], new_index[mesh.target(mesh.next(h))]}};
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            triangles[i] = t;
+        }
+    }, num_threads);
+    parallel_sort(triangles.begin(), triangles.end(), std::less<Triangle>(), num_threads);
+
+    Mesh reordered;
+    reordered.reserve(static_cast<size_type>(nv), static_cast<size_type>(mesh.number_of_edges()),
+                      static_cast<size_type>(nf));
+    for (std::size_t i = 0; i < nv; ++i) {
+        reordered.add_vertex(mesh.point(Vertex_index(keys[i].second)));
+    }
+    for (const Triangle& t : triangles) {
+        if (reordered.add_face(Vertex_index(t[0]), Vertex_index(t[1]), Vertex_index(t[2])) == Mesh::null_face()) {
+            return false;
+        }
+    }
+    mesh = std::move(reordered);
+    return true;
+}
+
+#endif
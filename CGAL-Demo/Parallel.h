@@ -0,0 +1,139 @@
+#ifndef LAR_PARALLEL_H
+#define LAR_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// 实际使用的线程数：0 表示使用全部硬件线程
+inline unsigned resolve_thread_count(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// 常驻执行器：安装后 parallel_for 的各块交给它执行，不再每次新建线程（如常驻服务的线程池）
+class Parallel_executor {
+public:
+    virtual ~Parallel_executor() {}
+    // 执行 task(0) … task(n - 1) 并在全部完成后返回，调用者线程也参与执行；task 不抛出异常
+    virtual void run_all(std::size_t n, const std::function<void(std::size_t)>& task) = 0;
+};
+
+inline std::atomic<Parallel_executor*>& parallel_executor_slot() {
+    static std::atomic<Parallel_executor*> executor(nullptr);
+    return executor;
+}
+
+// 在作用域内为整个进程安装执行器，离开时恢复原来的执行器
+class Parallel_executor_scope {
+public:
+    explicit Parallel_executor_scope(Parallel_executor* executor)
+        : previous_(parallel_executor_slot().exchange(executor)) {}
+    ~Parallel_executor_scope() { parallel_executor_slot().store(previous_); }
+
+    Parallel_executor_scope(const Parallel_executor_scope&) = delete;
+    Parallel_executor_scope& operator=(const Parallel_executor_scope&) = delete;
+
+private:
+    Parallel_executor* previous_;
+};
+
+// 把 [0, n) 切成连续的块，每块在一个线程上调用 f(begin, end, thread_index)
+// 块数不超过线程数，且每块至少 min_chunk 个元素，小规模输入直接在当前线程执行
+// 安装了执行器时由执行器调度各块，块的划分与 thread_index 不变；各块不应相互等待
+template <typename Function>
+void parallel_for(std::size_t n, const Function& f, unsigned num_threads = 0, std::size_t min_chunk = 4096) {
+    if (n == 0) {
+        return;
+    }
+    std::size_t threads = resolve_thread_count(num_threads);
+    threads = std::max<std::size_t>(1, std::min(threads, (n + min_chunk - 1) / min_chunk));
+    if (threads == 1) {
+        f(std::size_t(0), n, 0u);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    const std::size_t chunk = (n + threads - 1) / threads;
+    auto run_chunk = [&](std::size_t t) {
+        try {
+            f(std::min(n, t * chunk), std::min(n, (t + 1) * chunk), static_cast<unsigned>(t));
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    if (Parallel_executor* executor = parallel_executor_slot().load()) {
+        executor->run_all(threads, run_chunk);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (std::size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(run_chunk, t);
+        }
+        run_chunk(0);
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+// parallel_for 实际会切出的块数，用于预先分配每线程的局部缓冲
+inline unsigned parallel_chunk_count(std::size_t n, unsigned num_threads = 0, std::size_t min_chunk = 4096) {
+    std::size_t threads = resolve_thread_count(num_threads);
+    return static_cast<unsigned>(std::max<std::size_t>(1, std::min(threads, (n + min_chunk - 1) / min_chunk)));
+}
+
+// 动态调度：各线程从共享计数器领取下一个下标并调用 f(i, thread_index)
+// 适合代价差异很大的任务（如大小悬殊的连通分量）
+template <typename Function>
+void parallel_for_dynamic(std::size_t n, const Function& f, unsigned num_threads = 0) {
+    std::atomic<std::size_t> next(0);
+    const unsigned threads = static_cast<unsigned>(std::min<std::size_t>(resolve_thread_count(num_threads), n));
+    parallel_for(threads, [&](std::size_t, std::size_t, unsigned t) {
+        for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+            f(i, t);
+        }
+    }, threads, 1);
+}
+
+// 并行排序：各线程先排序自己的一段，再逐轮两两归并
+template <typename Iterator, typename Compare>
+void parallel_sort(Iterator first, Iterator last, Compare comp, unsigned num_threads = 0) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t threads = parallel_chunk_count(n, num_threads, 1 << 15);
+    if (threads <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    const std::size_t chunk = (n + threads - 1) / threads;
+    parallel_for(threads, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t t = b; t < e; ++t) {
+            std::sort(first + std::min(n, t * chunk), first + std::min(n, (t + 1) * chunk), comp);
+        }
+    }, num_threads, 1);
+    for (std::size_t width = chunk; width < n; width *= 2) {
+        const std::size_t merges = (n + 2 * width - 1) / (2 * width);
+        parallel_for(merges, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t m = b; m < e; ++m) {
+                const std::size_t lo = m * 2 * width;
+                const std::size_t mid = std::min(n, lo + width);
+                const std::size_t hi = std::min(n, lo + 2 * width);
+                std::inplace_merge(first + lo, first + mid, first + hi, comp);
+            }
+        }, num_threads, 1);
+    }
+}
+
+#endif
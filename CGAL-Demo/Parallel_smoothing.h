@@ -0,0 +1,279 @@
+#ifndef LAR_PARALLEL_SMOOTHING_H
+#define LAR_PARALLEL_SMOOTHING_H
+
+#include "Parallel.h"
+
+#include <CGAL/AABB_face_graph_triangle_primitive.h>
+#include <CGAL/AABB_traits.h>
+#include <CGAL/AABB_tree.h>
+#include <CGAL/Kernel_traits.h>
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/boost/graph/iterator.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// 并行角度与面积平滑参数，含义与 angle_and_area_smoothing 的同名参数一致
+struct Parallel_smoothing_options {
+    unsigned iterations = 1;
+    bool use_angle_smoothing = true;
+    bool use_area_smoothing = true;
+    // 拒绝使相邻面翻转或最小角变小的移动
+    bool use_safety_constraints = false;
+    // 把移动后的顶点投影回输入曲面
+    bool do_project = true;
+    // 线程数，0 表示使用全部硬件线程
+    unsigned num_threads = 0;
+};
+
+// 并行平滑结果
+struct Parallel_smoothing_report {
+    // 参与平滑的顶点数（不在边界上、也不与约束边相连）
+    std::size_t free_vertices = 0;
+    // 着色用到的颜色数，即每轮迭代的串行步数
+    std::size_t colors = 0;
+    // 所有迭代中被安全约束拒绝的移动次数
+    std::size_t rejected_moves = 0;
+};
+
+namespace internal_parallel_smoothing {
+
+typedef std::array<double, 3> Vec;
+
+inline Vec sub(const Vec& a, const Vec& b) { return Vec{{a[0] - b[0], a[1] - b[1], a[2] - b[2]}}; }
+inline double dot(const Vec& a, const Vec& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+inline Vec cross(const Vec& a, const Vec& b) {
+    return Vec{{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}};
+}
+inline double length(const Vec& a) { return std::sqrt(dot(a, a)); }
+
+// 着色优先级：编号打散后的哈希，与线程数无关；哈希相同时按编号区分
+inline std::uint64_t priority(std::uint64_t i) {
+    i += 0x9e3779b97f4a7c15ULL;
+    i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    i = (i ^ (i >> 27)) * 0x94d049bb133111ebULL;
+    return i ^ (i >> 31);
+}
+
+inline bool higher(std::uint64_t u, std::uint64_t v) {
+    const std::uint64_t pu = priority(u), pv = priority(v);
+    return pu != pv ? pu > pv : u > v;
+}
+
+// 三角形 (p, a, b) 的最小内角的余弦（越大角越小）
+inline double max_angle_cosine(const Vec& p, const Vec& a, const Vec& b) {
+    const Vec* c[3] = {&p, &a, &b};
+    double worst = -1.0;
+    for (int k = 0; k < 3; ++k) {
+        const Vec u = sub(*c[(k + 1) % 3], *c[k]), w = sub(*c[(k + 2) % 3], *c[k]);
+        const double len = length(u) * length(w);
+        worst = std::max(worst, len > 0.0 ? dot(u, w) / len : 1.0);
+    }
+    return worst;
+}
+
+} // namespace internal_parallel_smoothing
+
+// 按颜色分批的并行角度与面积平滑，对应 PMP::angle_and_area_smoothing：
+// 1. 边界顶点与约束边的端点固定不动，其余顶点按 Jones-Plassmann 方式并行着色：
+//    每轮中优先级高于所有未着色邻居的顶点取邻居未用的最小颜色，同色顶点互不相邻
+// 2. 每次迭代依次处理各颜色，同色顶点并发移动：每个顶点只读一环邻居、只写自身，
+//    且邻居都不同色，无需加锁，结果与线程数无关
+// 3. 角度平滑把顶点转到各邻居处夹角的平分线上后取平均；面积平滑移向相邻面按面积加权的重心；
+//    两者都开启时取中点，再用输入网格的 AABB 树投影回原曲面
+template <typename Point, typename EdgeIsConstrainedMap>
+Parallel_smoothing_report parallel_angle_and_area_smoothing(CGAL::Surface_mesh<Point>& mesh,
+                                                           EdgeIsConstrainedMap ecm,
+                                                           const Parallel_smoothing_options& options) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename CGAL::Kernel_traits<Point>::Kernel Kernel;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef CGAL::AABB_face_graph_triangle_primitive<Mesh> Primitive;
+    typedef CGAL::AABB_traits<Kernel, Primitive> Traits;
+    typedef CGAL::AABB_tree<Traits> Tree;
+    using namespace internal_parallel_smoothing;
+
+    Parallel_smoothing_report report;
+    const std::size_t nv = mesh.num_vertices();
+    auto position = [&](Vertex_index v) {
+        const Point& p = mesh.point(v);
+        return Vec{{CGAL::to_double(p.x()), CGAL::to_double(p.y()), CGAL::to_double(p.z())}};
+    };
+
+    // 1. 可动顶点：color 为 -1 表示待着色，-2 表示固定
+    std::vector<int> color(nv, -2);
+    std::vector<Vertex_index> pending;
+    for (Vertex_index v : mesh.vertices()) {
+        if (mesh.is_isolated(v) || mesh.is_border(v)) {
+            continue;
+        }
+        bool constrained = false;
+        for (auto h : CGAL::halfedges_around_target(mesh.halfedge(v), mesh)) {
+            constrained = constrained || get(ecm, mesh.edge(h));
+        }
+        if (!constrained) {
+            color[v] = -1;
+            pending.push_back(v);
+        }
+    }
+    report.free_vertices = pending.size();
+
+    std::vector<unsigned char> ready(nv, 0);
+    while (!pending.empty()) {
+        // 先判定本轮可着色的顶点，再着色：相邻两点不会同时就绪，着色时读到的邻居颜色都已确定
+        parallel_for(pending.size(), [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t i = b; i < e; ++i) {
+                const Vertex_index v = pending[i];
+                bool r = true;
+                for (Vertex_index u : CGAL::vertices_around_target(mesh.halfedge(v), mesh)) {
+                    r = r && !(color[u] == -1 && higher(u, v));
+                }
+                ready[v] = r;
+            }
+        }, options.num_threads, 1024);
+        parallel_for(pending.size(), [&](std::size_t b, std::size_t e, unsigned) {
+            std::vector<unsigned char> used;
+            for (std::size_t i = b; i < e; ++i) {
+                const Vertex_index v = pending[i];
+                if (!ready[v]) {
+                    continue;
+                }
+                used.assign(used.size(), 0);
+                for (Vertex_index u : CGAL::vertices_around_target(mesh.halfedge(v), mesh)) {
+                    if (color[u] >= 0) {
+                        if (static_cast<std::size_t>(color[u]) >= used.size()) {
+                            used.resize(color[u] + 1, 0);
+                        }
+                        used[color[u]] = 1;
+                    }
+                }
+                color[v] = static_cast<int>(std::find(used.begin(), used.end(), 0) - used.begin());
+            }
+        }, options.num_threads, 1024);
+        pending.erase(std::remove_if(pending.begin(), pending.end(), [&](Vertex_index v) { return color[v] >= 0; }),
+                      pending.end());
+    }
+
+    std::vector<std::vector<Vertex_index>> groups;
+    for (Vertex_index v : mesh.vertices()) {
+        if (color[v] >= 0) {
+            if (static_cast<std::size_t>(color[v]) >= groups.size()) {
+                groups.resize(color[v] + 1);
+            }
+            groups[color[v]].push_back(v);
+        }
+    }
+    report.colors = groups.size();
+    if (report.free_vertices == 0 || options.iterations == 0 ||
+        (!options.use_angle_smoothing && !options.use_area_smoothing)) {
+        return report;
+    }
+
+    // 投影目标是平滑前的曲面，树建在副本上，平滑时修改 mesh 不影响它
+    const Mesh input(mesh);
+    Tree tree(input.faces().begin(), input.faces().end(), input);
+    // 显式建树并构造距离查询的加速结构，之后的查询是只读的，可以并发执行
+    tree.build();
+    tree.accelerate_distance_queries();
+
+    for (unsigned iteration = 0; iteration < options.iterations; ++iteration) {
+        for (const std::vector<Vertex_index>& group : groups) {
+            std::vector<std::size_t> rejected(parallel_chunk_count(group.size(), options.num_threads, 256), 0);
+            parallel_for(group.size(), [&](std::size_t b, std::size_t e, unsigned t) {
+                std::vector<Vec> ring;
+                for (std::size_t i = b; i < e; ++i) {
+                    const Vertex_index v = group[i];
+                    const Vec p = position(v);
+                    // 一环顶点按环绕顺序排列，可动顶点不在边界上，环是闭合的
+                    ring.clear();
+                    for (Vertex_index u : CGAL::vertices_around_target(mesh.halfedge(v), mesh)) {
+                        ring.push_back(position(u));
+                    }
+                    const std::size_t n = ring.size();
+                    if (n < 3) {
+                        continue;
+                    }
+
+                    Vec angle_target = p, area_target = p;
+                    if (options.use_angle_smoothing) {
+                        Vec sum = {{0.0, 0.0, 0.0}};
+                        std::size_t count = 0;
+                        for (std::size_t j = 0; j < n; ++j) {
+                            const Vec& q = ring[j];
+                            const Vec a = sub(ring[(j + n - 1) % n], q), c = sub(ring[(j + 1) % n], q);
+                            const double la = length(a), lc = length(c), r = length(sub(p, q));
+                            if (la <= 0.0 || lc <= 0.0) {
+                                continue;
+                            }
+                            Vec bisector = {{a[0] / la + c[0] / lc, a[1] / la + c[1] / lc, a[2] / la + c[2] / lc}};
+                            const double lb = length(bisector);
+                            if (lb <= 0.0) {
+                                continue;
+                            }
+                            for (int k = 0; k < 3; ++k) {
+                                sum[k] += q[k] + r * bisector[k] / lb;
+                            }
+                            ++count;
+                        }
+                        if (count > 0) {
+                            angle_target = Vec{{sum[0] / count, sum[1] / count, sum[2] / count}};
+                        }
+                    }
+                    if (options.use_area_smoothing) {
+                        Vec sum = {{0.0, 0.0, 0.0}};
+                        double total = 0.0;
+                        for (std::size_t j = 0; j < n; ++j) {
+                            const Vec& a = ring[j];
+                            const Vec& c = ring[(j + 1) % n];
+                            const double area = length(cross(sub(a, p), sub(c, p)));
+                            for (int k = 0; k < 3; ++k) {
+                                sum[k] += area * (p[k] + a[k] + c[k]) / 3.0;
+                            }
+                            total += area;
+                        }
+                        if (total > 0.0) {
+                            area_target = Vec{{sum[0] / total, sum[1] / total, sum[2] / total}};
+                        }
+                    }
+                    Vec target = options.use_angle_smoothing && options.use_area_smoothing
+                                     ? Vec{{(angle_target[0] + area_target[0]) / 2,
+                                            (angle_target[1] + area_target[1]) / 2,
+                                            (angle_target[2] + area_target[2]) / 2}}
+                                     : options.use_angle_smoothing ? angle_target : area_target;
+                    if (options.do_project) {
+                        const Point projected = tree.closest_point(Point(target[0], target[1], target[2]));
+                        target = Vec{{CGAL::to_double(projected.x()), CGAL::to_double(projected.y()),
+                                      CGAL::to_double(projected.z())}};
+                    }
+
+                    if (options.use_safety_constraints) {
+                        // 相邻面法向不能反向，最小角不能变小
+                        bool safe = true;
+                        double before = -1.0, after = -1.0;
+                        for (std::size_t j = 0; j < n && safe; ++j) {
+                            const Vec& a = ring[j];
+                            const Vec& c = ring[(j + 1) % n];
+                            safe = dot(cross(sub(a, p), sub(c, p)), cross(sub(a, target), sub(c, target))) > 0.0;
+                            before = std::max(before, max_angle_cosine(p, a, c));
+                            after = std::max(after, max_angle_cosine(target, a, c));
+                        }
+                        if (!safe || after > before) {
+                            ++rejected[t];
+                            continue;
+                        }
+                    }
+                    mesh.point(v) = Point(target[0], target[1], target[2]);
+                }
+            }, options.num_threads, 256);
+            for (std::size_t r : rejected) {
+                report.rejected_moves += r;
+            }
+        }
+    }
+    return report;
+}
+
+#endif
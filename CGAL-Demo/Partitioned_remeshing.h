@@ -0,0 +1,306 @@
+#ifndef LAR_PARTITIONED_REMESHING_H
+#define LAR_PARTITIONED_REMESHING_H
+
+#include "Parallel.h"
+
+#include <CGAL/Random.h>
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/boost/graph/iterator.h>
+#include <CGAL/Polygon_mesh_processing/border.h>
+#include <CGAL/Polygon_mesh_processing/connected_components.h>
+#include <CGAL/Polygon_mesh_processing/orient_polygon_soup.h>
+#include <CGAL/Polygon_mesh_processing/polygon_soup_to_polygon_mesh.h>
+#include <CGAL/Polygon_mesh_processing/stitch_borders.h>
+#include <CGAL/Polygon_mesh_processing/surface_Delaunay_remeshing.h>
+#include <boost/property_map/vector_property_map.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 分块重划分参数
+struct Partitioned_remeshing_options {
+    // 单个分块的面数上限：由特征边围成的区域超过该值时按面重心递归二分，过小的区域合并成一块
+    std::size_t max_patch_faces = 50000;
+    // 线程数，0 表示使用全部硬件线程
+    unsigned num_threads = 0;
+};
+
+// 分块重划分结果
+struct Partitioned_remeshing_report {
+    // 由特征边围成的区域数
+    std::size_t regions = 0;
+    std::size_t patches = 0;
+    // 受保护的折线段数（特征边、分块交界与原有边界）
+    std::size_t constraint_polylines = 0;
+    // 分块重划分失败或交界没有完全缝合，改为整体重划分
+    bool fallback = false;
+};
+
+namespace internal_partitioned_remeshing {
+
+// 沿面重心包围盒的最长轴在中位数处递归二分，直到每段不超过 max_faces 个面
+inline void bisect(std::vector<std::uint32_t>& faces, std::size_t begin, std::size_t end,
+                   const std::vector<std::array<double, 3>>& centroid, std::size_t max_faces,
+                   std::vector<std::pair<std::size_t, std::size_t>>& parts) {
+    if (end - begin <= max_faces) {
+        parts.emplace_back(begin, end);
+        return;
+    }
+    std::array<double, 3> lo = centroid[faces[begin]], hi = lo;
+    for (std::size_t i = begin; i < end; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = std::min(lo[c], centroid[faces[i]][c]);
+            hi[c] = std::max(hi[c], centroid[faces[i]][c]);
+        }
+    }
+    int axis = 0;
+    for (int c = 1; c < 3; ++c) {
+        if (hi[c] - lo[c] > hi[axis] - lo[axis]) {
+            axis = c;
+        }
+    }
+    const std::size_t mid = begin + (end - begin) / 2;
+    std::nth_element(faces.begin() + begin, faces.begin() + mid, faces.begin() + end,
+                     [&](std::uint32_t a, std::uint32_t b) {
+                         return centroid[a][axis] != centroid[b][axis] ? centroid[a][axis] < centroid[b][axis] : a < b;
+                     });
+    bisect(faces, begin, mid, centroid, max_faces, parts);
+    bisect(faces, mid, end, centroid, max_faces, parts);
+}
+
+} // namespace internal_partitioned_remeshing
+
+// 分块并行的 surface_Delaunay_remeshing；size 同时约束特征边采样与面的大小，可以是常数场或自适应场：
+// 1. 按特征边把面分成区域，大区域按重心递归二分，小区域依次合并，得到面数相近的分块
+// 2. 特征边、分块交界与原有边界组成受保护的边图，在度不为 2 的顶点及两侧分块发生变化处切成折线；
+//    每条折线只生成一次，原样交给两侧的分块，两侧按同样的折线放置保护球，交界上的采样点一致
+// 3. 各分块复制成独立网格并发重划分（大块先领取，每块开始前重置本线程的默认随机数，结果与调度无关）
+// 4. 按分块顺序拼接并按坐标缝合交界；有分块失败或缝合后边界环数与输入不同时，退回整体重划分
+template <typename Point, typename EdgeIsFeatureMap, typename SizingField>
+CGAL::Surface_mesh<Point> partitioned_surface_Delaunay_remeshing(const CGAL::Surface_mesh<Point>& mesh,
+                                                                 EdgeIsFeatureMap eif, const SizingField& size,
+                                                                 double facet_distance,
+                                                                 const Partitioned_remeshing_options& options,
+                                                                 Partitioned_remeshing_report& report) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+    typedef typename Mesh::Edge_index Edge_index;
+    typedef typename Mesh::Face_index Face_index;
+    namespace PMP = CGAL::Polygon_mesh_processing;
+
+    report = Partitioned_remeshing_report();
+    auto remesh_whole = [&]() {
+        report.fallback = true;
+        return PMP::surface_Delaunay_remeshing(mesh, CGAL::parameters::protect_constraints(true)
+                                                         .mesh_edge_size(size)
+                                                         .mesh_facet_size(size)
+                                                         .mesh_facet_distance(facet_distance)
+                                                         .edge_is_constrained_map(eif));
+    };
+
+    // 1. 区域与分块
+    typedef typename boost::property_map<Mesh, boost::face_index_t>::const_type Face_id_map;
+    boost::vector_property_map<std::size_t, Face_id_map> region(get(boost::face_index, mesh));
+    report.regions = PMP::connected_components(mesh, region, CGAL::parameters::edge_is_constrained_map(eif));
+    std::vector<std::vector<std::uint32_t>> region_faces(report.regions);
+    std::vector<std::array<double, 3>> centroid(mesh.num_faces());
+    for (Face_index f : mesh.faces()) {
+        region_faces[region[f]].push_back(static_cast<std::uint32_t>(f));
+        std::array<double, 3> c = {{0.0, 0.0, 0.0}};
+        for (Vertex_index v : CGAL::vertices_around_face(mesh.halfedge(f), mesh)) {
+            for (int i = 0; i < 3; ++i) {
+                c[i] += CGAL::to_double(mesh.point(v)[i]) / 3.0;
+            }
+        }
+        centroid[f] = c;
+    }
+    const std::size_t max_faces = std::max<std::size_t>(1, options.max_patch_faces);
+    std::vector<std::vector<std::uint32_t>> patch_faces;
+    std::vector<std::uint32_t> small;
+    for (std::vector<std::uint32_t>& faces : region_faces) {
+        if (faces.size() > max_faces) {
+            std::vector<std::pair<std::size_t, std::size_t>> parts;
+            internal_partitioned_remeshing::bisect(faces, 0, faces.size(), centroid, max_faces, parts);
+            for (const auto& part : parts) {
+                patch_faces.emplace_back(faces.begin() + part.first, faces.begin() + part.second);
+            }
+            continue;
+        }
+        if (small.size() + faces.size() > max_faces) {
+            patch_faces.push_back(std::move(small));
+            small.clear();
+        }
+        small.insert(small.end(), faces.begin(), faces.end());
+    }
+    if (!small.empty()) {
+        patch_faces.push_back(std::move(small));
+    }
+    report.patches = patch_faces.size();
+    if (patch_faces.size() < 2) {
+        return remesh_whole();
+    }
+    const std::int64_t none = -1;
+    std::vector<std::int64_t> patch(mesh.num_faces(), none);
+    for (std::size_t p = 0; p < patch_faces.size(); ++p) {
+        for (std::uint32_t f : patch_faces[p]) {
+            patch[f] = static_cast<std::int64_t>(p);
+        }
+    }
+
+    // 2. 受保护的边图：边两侧的分块（边界一侧记为 -1），按从小到大排列
+    auto sides = [&](Edge_index e) {
+        const Halfedge_index h = mesh.halfedge(e);
+        const Face_index f0 = mesh.face(h), f1 = mesh.face(mesh.opposite(h));
+        std::int64_t a = f0 == Mesh::null_face() ? none : patch[f0];
+        std::int64_t b = f1 == Mesh::null_face() ? none : patch[f1];
+        return std::make_pair(std::min(a, b), std::max(a, b));
+    };
+    std::vector<char> constrained(mesh.num_edges(), 0);
+    std::vector<unsigned> degree(mesh.num_vertices(), 0);
+    for (Edge_index e : mesh.edges()) {
+        const auto s = sides(e);
+        if (get(eif, e) || s.first == none || s.first != s.second) {
+            constrained[e] = 1;
+            ++degree[mesh.vertex(e, 0)];
+            ++degree[mesh.vertex(e, 1)];
+        }
+    }
+    auto next_out = [&](Vertex_index v, Edge_index previous) {
+        for (Halfedge_index h : CGAL::halfedges_around_target(mesh.halfedge(v), mesh)) {
+            const Halfedge_index out = mesh.opposite(h);
+            if (constrained[mesh.edge(out)] && mesh.edge(out) != previous) {
+                return out;
+            }
+        }
+        return Mesh::null_halfedge();
+    };
+    std::vector<char> corner(mesh.num_vertices(), 0);
+    for (Vertex_index v : mesh.vertices()) {
+        if (degree[v] == 0) {
+            continue;
+        }
+        if (degree[v] != 2) {
+            corner[v] = 1;
+            continue;
+        }
+        const Halfedge_index a = next_out(v, Mesh::null_edge());
+        corner[v] = sides(mesh.edge(a)) != sides(mesh.edge(next_out(v, mesh.edge(a))));
+    }
+
+    std::vector<std::vector<Point>> polylines;
+    std::vector<std::pair<std::int64_t, std::int64_t>> polyline_sides;
+    std::vector<char> walked(mesh.num_edges(), 0);
+    auto walk = [&](Halfedge_index h) {
+        const Vertex_index start = mesh.source(h);
+        std::vector<Point> points(1, mesh.point(start));
+        polyline_sides.push_back(sides(mesh.edge(h)));
+        for (;;) {
+            walked[mesh.edge(h)] = 1;
+            const Vertex_index v = mesh.target(h);
+            points.push_back(mesh.point(v));
+            if (corner[v] || v == start) {
+                break;
+            }
+            h = next_out(v, mesh.edge(h));
+        }
+        polylines.push_back(std::move(points));
+    };
+    for (Vertex_index v : mesh.vertices()) {
+        if (!corner[v]) {
+            continue;
+        }
+        for (Halfedge_index h : CGAL::halfedges_around_target(mesh.halfedge(v), mesh)) {
+            const Halfedge_index out = mesh.opposite(h);
+            if (constrained[mesh.edge(out)] && !walked[mesh.edge(out)]) {
+                walk(out);
+            }
+        }
+    }
+    // 没有角点的闭合折线从编号最小的边开始
+    for (Edge_index e : mesh.edges()) {
+        if (constrained[e] && !walked[e]) {
+            walk(mesh.halfedge(e));
+        }
+    }
+    report.constraint_polylines = polylines.size();
+    std::vector<std::vector<std::vector<Point>>> patch_polylines(patch_faces.size());
+    for (std::size_t i = 0; i < polylines.size(); ++i) {
+        // 边总有一侧是面，排在后面的分块编号一定有效
+        const auto& s = polyline_sides[i];
+        if (s.first != none) {
+            patch_polylines[s.first].push_back(polylines[i]);
+        }
+        if (s.second != s.first) {
+            patch_polylines[s.second].push_back(polylines[i]);
+        }
+    }
+
+    // 3. 各分块复制为独立网格并发重划分
+    std::vector<std::size_t> order(patch_faces.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return patch_faces[a].size() > patch_faces[b].size(); });
+    std::vector<Mesh> remeshed(patch_faces.size());
+    std::vector<char> ok(patch_faces.size(), 0);
+    parallel_for_dynamic(order.size(), [&](std::size_t i, unsigned) {
+        const std::size_t p = order[i];
+        try {
+            // 经由三角形汤复制：二分切口上的非流形顶点被拆开，缝合时再按坐标合并
+            std::vector<Point> points;
+            std::vector<std::array<std::size_t, 3>> triangles;
+            std::unordered_map<Vertex_index, std::size_t> local;
+            for (std::uint32_t f : patch_faces[p]) {
+                std::array<std::size_t, 3> t;
+                int k = 0;
+                for (Vertex_index v : CGAL::vertices_around_face(mesh.halfedge(Face_index(f)), mesh)) {
+                    auto it = local.emplace(v, points.size());
+                    if (it.second) {
+                        points.push_back(mesh.point(v));
+                    }
+                    t[k++] = it.first->second;
+                }
+                triangles.push_back(t);
+            }
+            PMP::orient_polygon_soup(points, triangles);
+            Mesh sub;
+            PMP::polygon_soup_to_polygon_mesh(points, triangles, sub);
+            CGAL::get_default_random() = CGAL::Random(0);
+            remeshed[p] = PMP::surface_Delaunay_remeshing(sub, CGAL::parameters::protect_constraints(true)
+                                                                   .mesh_edge_size(size)
+                                                                   .mesh_facet_size(size)
+                                                                   .mesh_facet_distance(facet_distance)
+                                                                   .polyline_constraints(patch_polylines[p]));
+            ok[p] = !remeshed[p].is_empty();
+        } catch (...) {
+            ok[p] = 0;
+        }
+    }, options.num_threads);
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+        return remesh_whole();
+    }
+
+    // 4. 拼接并缝合交界
+    Mesh merged;
+    for (Mesh& part : remeshed) {
+        merged += part;
+        part = Mesh();
+    }
+    PMP::stitch_borders(merged);
+    merged.collect_garbage();
+    std::vector<Halfedge_index> before, after;
+    PMP::extract_boundary_cycles(mesh, std::back_inserter(before));
+    PMP::extract_boundary_cycles(merged, std::back_inserter(after));
+    if (before.size() != after.size()) {
+        return remesh_whole();
+    }
+    return merged;
+}
+
+#endif
@@ -3,15 +3,22 @@
 #include <CGAL/Polygon_mesh_processing/detect_features.h>
 #include <CGAL/Polygon_mesh_processing/surface_Delaunay_remeshing.h>
 #include <CGAL/Polygon_mesh_processing/IO/polygon_mesh_io.h>
-#include <CGAL/Mesh_constant_domain_field_3.h>
+// 自适应尺寸场：按顶点曲率与特征边距离给出局部边长，查询时只查均匀网格
+#include "../Adaptive_sizing_field.h"
+// 特征边缓存：所有边的二面角只计算一次，与输入网格一起保存，平滑示例可直接复用
+#include "../Feature_edges.h"
+// 分块并行重划分驱动：按特征边与重心二分切分网格，各分块并发重划分后再缝合
+#include "../Partitioned_remeshing.h"
+#include <chrono>
 #include <fstream>
+#include <iostream>
 
 // 定义使用的内核，精确的谓词和不精确的构造
 typedef CGAL::Exact_predicates_inexact_constructions_kernel   K;
 // 定义表面网格类型，使用上述内核的三维点
 typedef CGAL::Surface_mesh<K::Point_3>                        Mesh;
-// 定义尺寸场类型，用于指定网格边长
-typedef CGAL::Mesh_constant_domain_field_3<K, int> Sizing_field;
+// 定义尺寸场类型：平坦区域用较长的边，弯曲处与特征边附近用较短的边
+typedef Adaptive_sizing_field<K> Sizing_field;
 // 定义命名空间别名，方便后续使用多边形网格处理模块
 namespace PMP = CGAL::Polygon_mesh_processing;
 
@@ -29,12 +36,14 @@ int main(int argc, char* argv[])
         std::cerr << "Invalid input." << std::endl;
         return 1;
     }
-    // 确定目标边长，如果没有提供命令行参数，则使用默认值
+    // 确定目标边长（平坦区域的边长上限），如果没有提供命令行参数，则使用默认值
     double target_edge_length = (argc > 2) ? std::stod(std::string(argv[2])) : 0.02;
-    // 创建尺寸场对象，设置目标边长
-    Sizing_field size(target_edge_length);
     // 确定表面逼近距离，如果没有提供命令行参数，则使用默认值
     double fdist = (argc > 3) ? std::stod(std::string(argv[3])) : 0.01;
+    // 分块重划分参数：线程数（0 表示全部硬件线程）与单个分块的面数上限
+    Partitioned_remeshing_options options;
+    options.num_threads = (argc > 4) ? static_cast<unsigned>(std::stoul(std::string(argv[4]))) : 0;
+    options.max_patch_faces = (argc > 5) ? std::stoul(std::string(argv[5])) : 50000;
 
     // 输出提示信息，开始检测特征边
     std::cout << "Detect features..." << std::endl;
@@ -42,20 +51,44 @@ int main(int argc, char* argv[])
     using EIFMap = boost::property_map<Mesh, CGAL::edge_is_feature_t>::type;
     // 获取边是否为特征边的属性映射
     EIFMap eif = get(CGAL::edge_is_feature, mesh);
-    // 检测网格中的尖锐边，角度阈值为45度
-    PMP::detect_sharp_edges(mesh, 45, eif);
+    // 载入与输入网格一起保存的特征边缓存，没有或与网格不符时并行计算所有二面角并保存
+    Feature_edge_cache features;
+    if (!features.load(Feature_edge_cache::path_for(filename), mesh, options.num_threads))
+    {
+        features.compute(mesh, options.num_threads);
+        features.save(Feature_edge_cache::path_for(filename));
+    }
+    // 按缓存的二面角标记尖锐边，角度阈值为45度
+    std::size_t sharp_counter = features.mark_sharp_edges(mesh, 45, eif);
+    // 输出尖锐边的数量
+    std::cout << sharp_counter << " sharp edges" << std::endl;
+
+    // 创建自适应尺寸场：边长在目标边长的 1/10 到目标边长之间，由曲率与弦高误差决定
+    Adaptive_sizing_options sizing;
+    sizing.max_size = target_edge_length;
+    sizing.min_size = target_edge_length / 10;
+    sizing.facet_distance = fdist;
+    sizing.num_threads = options.num_threads;
+    Sizing_field size(mesh, eif, sizing);
+    // 输出尺寸场查找网格的格子数
+    std::cout << "Sizing field: " << size.number_of_cells() << " cells" << std::endl;
 
     // 输出提示信息，开始重新网格化
     std::cout << "Start remeshing of " << filename
         << " (" << num_faces(mesh) << " faces)..." << std::endl;
-    // 进行表面Delaunay重新网格化，设置相关参数
-    Mesh outmesh = PMP::surface_Delaunay_remeshing(mesh,
-        CGAL::parameters::protect_constraints(true)
-        .mesh_edge_size(size)
-        .mesh_facet_distance(fdist)
-        .edge_is_constrained_map(eif));
+    // 记录开始时间
+    auto start = std::chrono::steady_clock::now();
+    // 分块并行进行表面Delaunay重新网格化：特征边与分块交界作为受保护的折线，两侧分块共用同一组折线
+    Partitioned_remeshing_report report;
+    Mesh outmesh = partitioned_surface_Delaunay_remeshing(mesh, eif, size, fdist, options, report);
+    // 计算耗时
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // 输出分块情况：区域数、分块数、受保护折线数，以及是否退回了整体重划分
+    std::cout << report.regions << " regions, " << report.patches << " patches, "
+        << report.constraint_polylines << " constrained polylines"
+        << (report.fallback ? " (fell back to whole-mesh remeshing)" : "") << std::endl;
     // 输出提示信息，重新网格化完成
-    std::cout << "Remeshing done." << std::endl;
+    std::cout << "Remeshing done in " << seconds << " s (" << num_faces(outmesh) << " faces)." << std::endl;
 
     // 打开输出文件
     std::ofstream ofs("anchor_remeshed.off");
@@ -2,12 +2,16 @@
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 // 引入表面网格类，用于处理三维网格数据
 #include <CGAL/Surface_mesh.h>
-// 引入角度和面积平滑功能的头文件，提供网格平滑算法
-#include <CGAL/Polygon_mesh_processing/angle_and_area_smoothing.h>
+// 引入按颜色分批的并行角度与面积平滑，替代串行的 PMP::angle_and_area_smoothing
+#include "../Parallel_smoothing.h"
 // 引入特征检测功能的头文件，用于检测网格中的尖锐边
 #include <CGAL/Polygon_mesh_processing/detect_features.h>
 // 引入多边形网格输入输出功能的头文件，用于读取和写入网格文件
 #include <CGAL/Polygon_mesh_processing/IO/polygon_mesh_io.h>
+// 引入特征边缓存：二面角只计算一次，可复用重划分示例保存的结果
+#include "../Feature_edges.h"
+// 引入计时库，用于输出平滑耗时
+#include <chrono>
 // 引入输入输出流库，用于在控制台输出信息
 #include <iostream>
 // 引入字符串库，用于处理文件路径和命令行参数
@@ -42,19 +46,15 @@ int main(int argc, char** argv)
     typedef boost::property_map<Mesh, CGAL::edge_is_feature_t>::type EIFMap;
     // 获取该属性映射
     EIFMap eif = get(CGAL::edge_is_feature, mesh);
-    // 检测网格中两面夹角大于 60° 的边，并将这些边标记为特征边
-    PMP::detect_sharp_edges(mesh, 60, eif);
-
-    // 统计尖锐边的数量
-    int sharp_counter = 0;
-    // 遍历网格中的所有边
-    for (edge_descriptor e : edges(mesh))
+    // 载入与输入网格一起保存的特征边缓存（例如重划分示例已经算过的），没有或与网格不符时重新计算并保存
+    Feature_edge_cache features;
+    if (!features.load(Feature_edge_cache::path_for(filename), mesh))
     {
-        // 如果当前边被标记为特征边
-        if (get(eif, e))
-            // 尖锐边数量加 1
-            ++sharp_counter;
+        features.compute(mesh);
+        features.save(Feature_edge_cache::path_for(filename));
     }
+    // 把两面夹角大于 60° 的边标记为特征边，标记时顺带统计尖锐边的数量，不再遍历第二遍
+    std::size_t sharp_counter = features.mark_sharp_edges(mesh, 60, eif);
     // 输出尖锐边的数量
     std::cout << sharp_counter << " sharp edges" << std::endl;
 
@@ -62,17 +62,25 @@ int main(int argc, char** argv)
     // 如果命令行提供了第二个参数，则将其转换为整数作为迭代次数
     // 否则，使用默认值 10
     const unsigned int nb_iterations = (argc > 2) ? std::atoi(argv[2]) : 10;
+    // 设置并行平滑的参数
+    Parallel_smoothing_options options;
+    // 设置平滑的迭代次数
+    options.iterations = nb_iterations;
+    // 不使用安全约束，允许所有可能的顶点移动操作
+    options.use_safety_constraints = false;
+    // 如果命令行提供了第三个参数，则作为线程数，否则使用全部硬件线程
+    options.num_threads = (argc > 3) ? static_cast<unsigned>(std::atoi(argv[3])) : 0;
     // 输出开始网格平滑的信息，包含迭代次数
     std::cout << "Smoothing mesh... (" << nb_iterations << " iterations)" << std::endl;
 
-    // 调用角度和面积平滑函数，对网格进行平滑处理
-    PMP::angle_and_area_smoothing(mesh,
-        // 设置平滑的迭代次数
-        CGAL::parameters::number_of_iterations(nb_iterations)
-        // 不使用安全约束，允许所有可能的顶点移动操作
-        .use_safety_constraints(false)
-        // 传入之前标记的特征边映射，确保这些尖锐边在平滑过程中不被改变
-        .edge_is_constrained_map(eif));
+    // 调用并行角度和面积平滑函数：顶点按着色分批，同色顶点并发移动
+    // 传入之前标记的特征边映射，确保这些尖锐边在平滑过程中不被改变
+    auto start = std::chrono::steady_clock::now();
+    Parallel_smoothing_report report = parallel_angle_and_area_smoothing(mesh, eif, options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // 输出参与平滑的顶点数、颜色数与耗时
+    std::cout << report.free_vertices << " free vertices in " << report.colors << " colors, "
+        << seconds << " s" << std::endl;
 
     // 将平滑后的网格写入文件 "mesh_smoothed.off"
     // stream_precision(17) 指定输出文件的精度为 17 位
@@ -0,0 +1,276 @@
+#include "Repair_cache.h"
+#include "File_util.h"
+#include "Parallel.h"
+#include "STL_reader.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// 缓存格式版本，条目布局或修复流程的语义变化时递增，使旧条目自然失效
+const char cache_version[] = "lar-cache-4";
+const std::size_t hash_block = std::size_t(1) << 20;
+
+const std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+const std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+const std::uint64_t prime3 = 0x165667B19E3779F9ull;
+const std::uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+
+inline std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline std::uint64_t mix64(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+struct Hash128 {
+    std::uint64_t lo, hi;
+};
+
+// 单块哈希：两条独立的乘法-旋转链，每次消费 8 字节
+Hash128 hash_block_bytes(const char* data, std::size_t size, std::uint64_t index) {
+    std::uint64_t h1 = prime1 ^ index, h2 = prime2 + index;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h1 = rotl(h1 ^ (w * prime2), 31) * prime1;
+        h2 = rotl(h2 + (w * prime4), 27) * prime3;
+    }
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    h1 = mix64(h1 ^ tail ^ size);
+    h2 = mix64(h2 + tail + h1);
+    return {h1, h2};
+}
+
+std::string to_hex(std::uint64_t v) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(v));
+    return buf;
+}
+
+// 缓存目录下 lock 文件上的 flock，析构时释放
+class File_lock {
+public:
+    File_lock(const std::string& directory, int operation)
+        : fd_(::open((directory + "/lock").c_str(), O_RDWR | O_CREAT, 0644)) {
+        if (fd_ >= 0 && ::flock(fd_, operation) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+    ~File_lock() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+    bool locked() const { return fd_ >= 0; }
+
+private:
+    int fd_;
+};
+
+// 在缓存目录中创建临时文件，返回其路径；失败时返回空串
+std::string make_temporary(const std::string& directory) {
+    std::string pattern = directory + "/.tmp-XXXXXX";
+    std::vector<char> buf(pattern.begin(), pattern.end());
+    buf.push_back('\0');
+    int fd = ::mkstemp(buf.data());
+    if (fd < 0) {
+        return std::string();
+    }
+    ::close(fd);
+    return std::string(buf.data());
+}
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+std::string hash_bytes(const char* data, std::size_t size, unsigned num_threads) {
+    const std::size_t blocks = (size + hash_block - 1) / hash_block;
+    std::vector<Hash128> partial(blocks);
+    parallel_for(blocks, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) {
+            const std::size_t begin = i * hash_block;
+            partial[i] = hash_block_bytes(data + begin, std::min(hash_block, size - begin), i);
+        }
+    }, num_threads, 1);
+
+    std::uint64_t h1 = prime3 ^ size, h2 = prime4 + size;
+    for (const Hash128& p : partial) {
+        h1 = mix64(h1 * prime1 ^ p.lo);
+        h2 = mix64(h2 * prime2 ^ p.hi);
+    }
+    return to_hex(h1) + to_hex(h2);
+}
+
+Repair_cache::Repair_cache(const std::string& directory, std::uint64_t max_bytes)
+    : directory_(directory), max_bytes_(max_bytes) {}
+
+std::string Repair_cache::default_directory() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg != nullptr && *xdg != '\0') {
+        return std::string(xdg) + "/lar_stl";
+    }
+    const char* home = std::getenv("HOME");
+    return std::string(home != nullptr ? home : ".") + "/.cache/lar_stl";
+}
+
+std::string Repair_cache::key(const std::string& input, const std::string& settings, unsigned num_threads) const {
+    Mapped_file file(input);
+    if (!file.is_open()) {
+        return std::string();
+    }
+    const std::string content = hash_bytes(file.data(), file.size(), num_threads);
+    const std::string params = std::string(cache_version) + ";" + settings;
+    return content + "-" + hash_bytes(params.data(), params.size(), 1).substr(0, 16);
+}
+
+std::string Repair_cache::entry_path(const std::string& key, const char* suffix) const {
+    return directory_ + "/" + key + suffix;
+}
+
+bool Repair_cache::lookup(const std::string& key, const std::string& output, std::string& report) const {
+    if (key.empty()) {
+        return false;
+    }
+    struct stat st;
+    if (::stat(directory_.c_str(), &st) != 0) {
+        return false;
+    }
+    // 共享锁期间条目不会被淘汰或替换
+    File_lock lock(directory_, LOCK_SH);
+    if (!lock.locked()) {
+        return false;
+    }
+    const std::string mesh_path = entry_path(key, ".stl");
+    std::ifstream json(entry_path(key, ".json"));
+    if (!json || ::access(mesh_path.c_str(), R_OK) != 0) {
+        return false;
+    }
+    std::stringstream ss;
+    ss << json.rdbuf();
+    if (!copy_file(mesh_path, output)) {
+        return false;
+    }
+    report = ss.str();
+    // 刷新 mtime，淘汰按最近使用时间进行
+    ::utimensat(AT_FDCWD, mesh_path.c_str(), nullptr, 0);
+    return true;
+}
+
+bool Repair_cache::store(const std::string& key, const std::string& repaired, const std::string& report) const {
+    if (key.empty() || !make_directories(directory_)) {
+        return false;
+    }
+    // 复制在锁外进行，只有 rename 与淘汰需要独占锁
+    const std::string mesh_tmp = make_temporary(directory_);
+    const std::string json_tmp = make_temporary(directory_);
+    bool ok = !mesh_tmp.empty() && !json_tmp.empty() && copy_file(repaired, mesh_tmp);
+    if (ok) {
+        std::ofstream os(json_tmp);
+        os << report;
+        ok = static_cast<bool>(os);
+    }
+    if (ok) {
+        File_lock lock(directory_, LOCK_EX);
+        // 先放报告再放网格：网格存在即表示条目完整；网格放置失败时撤回报告，不留下孤立的 .json
+        const std::string json_path = entry_path(key, ".json");
+        ok = lock.locked() && std::rename(json_tmp.c_str(), json_path.c_str()) == 0;
+        if (ok && std::rename(mesh_tmp.c_str(), entry_path(key, ".stl").c_str()) != 0) {
+            std::remove(json_path.c_str());
+            ok = false;
+        }
+        if (ok) {
+            evict();
+        }
+    }
+    if (!ok) {
+        if (!mesh_tmp.empty()) {
+            std::remove(mesh_tmp.c_str());
+        }
+        if (!json_tmp.empty()) {
+            std::remove(json_tmp.c_str());
+        }
+    }
+    return ok;
+}
+
+void Repair_cache::evict() const {
+    struct Entry {
+        std::string key;
+        std::uint64_t bytes;
+        std::time_t used;
+    };
+    std::vector<Entry> entries;
+    std::uint64_t total = 0;
+
+    DIR* dir = ::opendir(directory_.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    const std::time_t now = std::time(nullptr);
+    while (dirent* ent = ::readdir(dir)) {
+        const std::string name = ent->d_name;
+        struct stat st;
+        if (::stat((directory_ + "/" + name).c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        if (name.compare(0, 5, ".tmp-") == 0) {
+            // 崩溃进程遗留的临时文件，一天后清理
+            if (now - st.st_mtime > 24 * 3600) {
+                std::remove((directory_ + "/" + name).c_str());
+            }
+        } else if (ends_with(name, ".json")) {
+            // 没有对应网格的报告：进程在两次 rename 之间崩溃的遗留；淘汰持有独占锁，不会是进行中的写入
+            struct stat ms;
+            if (::stat(entry_path(name.substr(0, name.size() - 5), ".stl").c_str(), &ms) != 0) {
+                std::remove((directory_ + "/" + name).c_str());
+            }
+        } else if (ends_with(name, ".stl")) {
+            struct stat js;
+            const std::string key = name.substr(0, name.size() - 4);
+            const std::uint64_t json_bytes =
+                ::stat(entry_path(key, ".json").c_str(), &js) == 0 ? static_cast<std::uint64_t>(js.st_size) : 0;
+            entries.push_back({key, static_cast<std::uint64_t>(st.st_size) + json_bytes, st.st_mtime});
+            total += entries.back().bytes;
+        }
+    }
+    ::closedir(dir);
+
+    if (total <= max_bytes_) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.used != b.used ? a.used < b.used : a.key < b.key;
+    });
+    for (const Entry& e : entries) {
+        if (total <= max_bytes_) {
+            break;
+        }
+        std::remove(entry_path(e.key, ".stl").c_str());
+        std::remove(entry_path(e.key, ".json").c_str());
+        total -= e.bytes;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef LAR_REPAIR_CACHE_H
+#define LAR_REPAIR_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+// 对一段内存计算 128 位内容哈希（十六进制串）：按 1 MB 分块并行计算，再按块序合并，结果与线程数无关
+std::string hash_bytes(const char* data, std::size_t size, unsigned num_threads = 0);
+
+// 修复结果的本地磁盘缓存，键为输入文件内容哈希与修复参数的组合
+// 每个条目是 <键>.stl（修复后的网格）和 <键>.json（修复报告）两个文件：
+// - 写入先写临时文件再 rename，读者永远看不到写了一半的条目
+// - 目录下的 lock 文件用 flock 协调多个进程：查找持共享锁，写入与淘汰持独占锁
+// - 总大小超过上限时按最近使用时间（命中时刷新 mtime）淘汰最旧的条目
+class Repair_cache {
+public:
+    Repair_cache(const std::string& directory, std::uint64_t max_bytes);
+
+    // $XDG_CACHE_HOME/lar_stl，未设置时为 ~/.cache/lar_stl
+    static std::string default_directory();
+
+    // 由输入文件内容和修复参数描述计算键；文件无法读取时返回空串
+    std::string key(const std::string& input, const std::string& settings, unsigned num_threads = 0) const;
+
+    // 命中时把缓存的网格复制到 output，并读出报告；未命中返回 false
+    bool lookup(const std::string& key, const std::string& output, std::string& report) const;
+
+    // 把已写出的修复结果与报告存入缓存，随后按容量上限淘汰
+    bool store(const std::string& key, const std::string& repaired, const std::string& report) const;
+
+private:
+    // 持有独占锁时调用
+    void evict() const;
+    std::string entry_path(const std::string& key, const char* suffix) const;
+
+    std::string directory_;
+    std::uint64_t max_bytes_;
+};
+
+#endif
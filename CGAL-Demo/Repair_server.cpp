@@ -0,0 +1,370 @@
+#include "Repair_server.h"
+#include "Thread_pool.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> stop_requested(false);
+
+void request_stop(int) {
+    stop_requested = true;
+}
+
+// 单行请求的长度上限，防止异常客户端占满内存
+const std::size_t max_line = 1 << 16;
+// 轮询间隔（毫秒）：阻塞等待时定期检查是否收到停止信号
+const int poll_interval = 200;
+
+bool make_address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+int connect_to(const std::string& path) {
+    sockaddr_un addr;
+    if (!make_address(path, addr)) {
+        return -1;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+bool send_all(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// 客户端从套接字按行读取应答
+class Line_reader {
+public:
+    explicit Line_reader(int fd) : fd_(fd) {}
+
+    bool read_line(std::string& line) {
+        for (;;) {
+            std::size_t newline = buffer_.find('\n');
+            if (newline != std::string::npos) {
+                line = buffer_.substr(0, newline);
+                buffer_.erase(0, newline + 1);
+                return true;
+            }
+            if (buffer_.size() > max_line) {
+                return false;
+            }
+            pollfd p = {fd_, POLLIN, 0};
+            int r = ::poll(&p, 1, poll_interval);
+            if (r < 0 && errno != EINTR) {
+                return false;
+            }
+            if (r <= 0) {
+                continue;
+            }
+            char chunk[4096];
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            buffer_.append(chunk, static_cast<std::size_t>(n));
+        }
+    }
+
+private:
+    int fd_;
+    std::string buffer_;
+};
+
+std::vector<std::string> split_fields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::size_t begin = 0;
+    for (;;) {
+        std::size_t tab = line.find('\t', begin);
+        fields.push_back(line.substr(begin, tab == std::string::npos ? std::string::npos : tab - begin));
+        if (tab == std::string::npos) {
+            return fields;
+        }
+        begin = tab + 1;
+    }
+}
+
+// 服务期间共享的状态
+struct Server_state {
+    Repair_options options;
+    // 每个工作线程一份网格存储，按 Thread_pool::current_worker() 取用
+    std::vector<Surface_mesh> storage;
+    std::mutex log_mutex;
+};
+
+std::string run_job(Server_state& state, int worker, const std::string& input, const std::string& output) {
+    auto start = std::chrono::steady_clock::now();
+    std::ostringstream reply;
+    Surface_mesh& storage = state.storage[worker];
+    try {
+        LAR_STL stl_processor(input, state.options, std::move(storage));
+        const Surface_mesh& mesh = stl_processor.get_repaired_mesh();
+        if (mesh.is_empty()) {
+            reply << "ERR\t加载或修复失败";
+        } else if (!stl_processor.save_repaired_mesh(output)) {
+            reply << "ERR\t保存失败";
+        } else {
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            reply << "OK\t" << mesh.number_of_vertices() << '\t' << mesh.number_of_faces() << '\t'
+                  << (stl_processor.check_manifold().is_manifold() ? 1 : 0) << '\t' << seconds;
+        }
+        storage = stl_processor.release_mesh();
+    } catch (const std::exception& e) {
+        // 存储已被移入失败的任务，换一份新的
+        storage = Surface_mesh();
+        reply << "ERR\t" << e.what();
+    }
+    return reply.str();
+}
+
+// 一个客户端连接：请求按行缓存在 buffer 中，同一时刻至多一个任务在线程池中执行，应答顺序与请求一致
+// busy 为真期间只有执行任务的工作线程向 fd 写应答，接收线程既不读取也不关闭这个连接
+struct Connection {
+    explicit Connection(int f) : fd(f) {}
+    ~Connection() { ::close(fd); }
+
+    int fd;
+    std::string buffer;
+    bool eof = false;
+    std::atomic<bool> busy{false};
+};
+
+// 接收线程：在一个 poll 循环里处理所有连接的读取，每个 REPAIR 请求作为一个独立任务提交给线程池，
+// 空闲或长时间保持的连接不占用工作线程；任务结束后写应答，并通过 wake 管道唤醒接收线程继续处理该连接
+class Dispatcher {
+public:
+    Dispatcher(Server_state& state, Thread_pool& pool, int wake_read, int wake_write)
+        : state_(state), pool_(pool), wake_read_(wake_read), wake_write_(wake_write) {}
+
+    void add(int fd) { connections_.push_back(std::make_shared<Connection>(fd)); }
+
+    // 等待可读的连接、新连接或任务完成，返回 listener 是否可以 accept
+    bool poll_once(int listener) {
+        std::vector<pollfd> fds = {{listener, POLLIN, 0}, {wake_read_, POLLIN, 0}};
+        std::vector<std::size_t> polled;
+        for (std::size_t i = 0; i < connections_.size(); ++i) {
+            if (!connections_[i]->busy.load(std::memory_order_acquire) && !connections_[i]->eof) {
+                fds.push_back({connections_[i]->fd, POLLIN, 0});
+                polled.push_back(i);
+            }
+        }
+        if (::poll(fds.data(), fds.size(), poll_interval) <= 0) {
+            return false;
+        }
+        if (fds[1].revents != 0) {
+            char drain[64];
+            while (::read(wake_read_, drain, sizeof(drain)) > 0) {
+            }
+        }
+        for (std::size_t k = 0; k < polled.size(); ++k) {
+            if (fds[k + 2].revents == 0) {
+                continue;
+            }
+            Connection& c = *connections_[polled[k]];
+            char chunk[4096];
+            ssize_t n = ::recv(c.fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                c.eof = true;
+            } else {
+                c.buffer.append(chunk, static_cast<std::size_t>(n));
+            }
+        }
+        return fds[0].revents != 0;
+    }
+
+    // 处理空闲连接中已缓存的完整请求行，并关闭已结束的连接
+    void dispatch() {
+        for (std::size_t i = 0; i < connections_.size();) {
+            std::shared_ptr<Connection> c = connections_[i];
+            bool drop = false;
+            while (!drop && !c->busy.load(std::memory_order_acquire)) {
+                std::size_t newline = c->buffer.find('\n');
+                if (newline == std::string::npos) {
+                    drop = c->eof || c->buffer.size() > max_line;
+                    break;
+                }
+                std::string line = c->buffer.substr(0, newline);
+                c->buffer.erase(0, newline + 1);
+                drop = !handle(c, line);
+            }
+            if (drop && !c->busy.load(std::memory_order_acquire)) {
+                connections_.erase(connections_.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void close_all() { connections_.clear(); }
+
+private:
+    // 返回 false 表示连接应当关闭
+    bool handle(const std::shared_ptr<Connection>& c, std::string line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        std::vector<std::string> fields = split_fields(line);
+        if (fields[0] == "PING") {
+            return send_all(c->fd, "PONG\n");
+        }
+        if (fields[0] != "REPAIR" || fields.size() != 3) {
+            return send_all(c->fd, "ERR\t无法识别的请求\n");
+        }
+        c->busy.store(true, std::memory_order_release);
+        Server_state& state = state_;
+        Thread_pool& pool = pool_;
+        const int wake = wake_write_;
+        pool_.submit([&state, &pool, c, fields, wake]() {
+            const std::string reply = run_job(state, pool.current_worker(), fields[1], fields[2]);
+            {
+                std::lock_guard<std::mutex> lock(state.log_mutex);
+                std::cout << fields[1] << " -> " << fields[2] << ": " << reply << std::endl;
+            }
+            if (!send_all(c->fd, reply + "\n")) {
+                c->eof = true;
+            }
+            c->busy.store(false, std::memory_order_release);
+            const char byte = 0;
+            ssize_t ignored = ::write(wake, &byte, 1);
+            (void)ignored;
+        });
+        return true;
+    }
+
+    Server_state& state_;
+    Thread_pool& pool_;
+    int wake_read_;
+    int wake_write_;
+    std::vector<std::shared_ptr<Connection>> connections_;
+};
+
+} // namespace
+
+bool run_repair_server(const std::string& socket_path, const Repair_options& options, unsigned workers) {
+    sockaddr_un addr;
+    if (!make_address(socket_path, addr)) {
+        std::cerr << "错误：套接字路径过长 " << socket_path << std::endl;
+        return false;
+    }
+    // 路径已存在时：能连上说明已有服务在运行，否则是上次异常退出留下的，直接删除
+    int existing = connect_to(socket_path);
+    if (existing >= 0) {
+        ::close(existing);
+        std::cerr << "错误：已有服务在 " << socket_path << " 上运行" << std::endl;
+        return false;
+    }
+    ::unlink(socket_path.c_str());
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listener, 128) != 0) {
+        std::cerr << "错误：无法监听 " << socket_path << ": " << std::strerror(errno) << std::endl;
+        if (listener >= 0) {
+            ::close(listener);
+        }
+        return false;
+    }
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+
+    // 任务完成时写一个字节唤醒接收线程
+    int wake[2];
+    if (::pipe2(wake, O_CLOEXEC | O_NONBLOCK) != 0) {
+        std::cerr << "错误：无法创建唤醒管道: " << std::strerror(errno) << std::endl;
+        ::close(listener);
+        ::unlink(socket_path.c_str());
+        return false;
+    }
+
+    Server_state state;
+    state.options = options;
+    state.options.verbose = false;
+    {
+        Thread_pool pool(workers);
+        // 各修复阶段的 parallel_for 也交给这个常驻线程池，不再为每次调用新建线程
+        Parallel_executor_scope executor(&pool);
+        state.storage.resize(pool.size());
+        std::cout << "修复服务已启动：" << socket_path << "，" << pool.size() << " 个工作线程" << std::endl;
+
+        Dispatcher dispatcher(state, pool, wake[0], wake[1]);
+        while (!stop_requested) {
+            if (dispatcher.poll_once(listener)) {
+                int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client >= 0) {
+                    dispatcher.add(client);
+                }
+            }
+            dispatcher.dispatch();
+        }
+        ::close(listener);
+        ::unlink(socket_path.c_str());
+        pool.wait();
+        dispatcher.close_all();
+    }
+    ::close(wake[0]);
+    ::close(wake[1]);
+    std::cout << "修复服务已停止" << std::endl;
+    return true;
+}
+
+bool send_repair_request(const std::string& socket_path, const std::string& input, const std::string& output,
+                         std::string& reply) {
+    int fd = connect_to(socket_path);
+    if (fd < 0) {
+        reply = "无法连接修复服务 " + socket_path;
+        return false;
+    }
+    bool ok = send_all(fd, "REPAIR\t" + input + "\t" + output + "\n");
+    if (ok) {
+        Line_reader reader(fd);
+        ok = reader.read_line(reply);
+    }
+    ::close(fd);
+    return ok && reply.compare(0, 3, "OK\t") == 0;
+}
@@ -0,0 +1,24 @@
+#ifndef LAR_REPAIR_SERVER_H
+#define LAR_REPAIR_SERVER_H
+
+#include "LAR_STL.h"
+
+#include <string>
+
+// 常驻修复服务：在 Unix 域套接字上接收修复任务，省去每次启动进程、加载 CGAL/GMP/MPFR 动态库与分配器预热的开销
+// 协议为按行的文本，字段以制表符分隔，一个连接上可以连续发送多个请求：
+//   REPAIR\t<输入路径>\t<输出路径>   ->  OK\t<顶点数>\t<面数>\t<是否流形 0/1>\t<耗时秒>
+//                                   或 ERR\t<原因>
+//   PING                            ->  PONG
+// 路径按服务进程的工作目录解析，客户端应发送绝对路径
+// 一个接收线程轮询所有连接，每个修复请求作为一个任务交给线程池，空闲连接不占用工作线程；
+// 同一连接上的请求依次执行，应答顺序与请求一致；各修复阶段的 parallel_for 也在同一个常驻线程池上执行
+// 每个工作线程保留一份网格存储，跨任务复用已分配的容量
+// 收到 SIGINT / SIGTERM 后停止接受新连接，等待进行中的任务结束后退出
+bool run_repair_server(const std::string& socket_path, const Repair_options& options, unsigned workers);
+
+// 客户端：连接服务并提交一个修复任务，reply 为服务返回的整行（不含换行）
+bool send_repair_request(const std::string& socket_path, const std::string& input, const std::string& output,
+                         std::string& reply);
+
+#endif
@@ -0,0 +1,225 @@
+#include "STL_reader.h"
+#include "Parallel.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+Mapped_file::Mapped_file(const std::string& filename) : data_(nullptr), size_(0) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            // 面片按顺序遍历，提示内核积极预读
+            ::madvise(addr, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            size_ = static_cast<std::size_t>(st.st_size);
+        }
+    }
+    // 映射建立后即可关闭文件描述符
+    ::close(fd);
+}
+
+Mapped_file::~Mapped_file() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+Binary_STL_view::Binary_STL_view(const char* data, std::size_t size)
+    : data_(data), nb_facets_(0), valid_(false) {
+    if (data == nullptr || size < header_size) {
+        return;
+    }
+    std::uint32_t n = 0;
+    std::memcpy(&n, data + 80, sizeof(n));
+    const std::size_t expected = header_size + static_cast<std::size_t>(n) * facet_size;
+    // 以 "solid" 开头且长度不完全吻合的文件按 ASCII 处理
+    const bool ascii_header = std::strncmp(data, "solid", 5) == 0;
+    if (size == expected || (!ascii_header && size > expected)) {
+        nb_facets_ = n;
+        valid_ = true;
+    }
+}
+
+namespace {
+
+// 以坐标的位模式作为键，-0.0 归一为 0.0
+struct Point_key {
+    std::uint32_t c[3];
+    bool operator==(const Point_key& o) const { return c[0] == o.c[0] && c[1] == o.c[1] && c[2] == o.c[2]; }
+};
+
+struct Point_key_hash {
+    std::size_t operator()(const Point_key& k) const {
+        std::uint64_t h = k.c[0] * 0x9E3779B97F4A7C15ull;
+        h ^= (k.c[1] + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+        h ^= (k.c[2] + 0x165667B19E3779F9ull) * 0x27D4EB2F165667C5ull;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+
+Point_key make_key(const float p[3]) {
+    Point_key k;
+    for (int i = 0; i < 3; ++i) {
+        float v = (p[i] == 0.0f) ? 0.0f : p[i];
+        std::memcpy(&k.c[i], &v, sizeof(float));
+    }
+    return k;
+}
+
+} // namespace
+
+void read_binary_STL(const Binary_STL_view& view, STL_soup& soup) {
+    const std::size_t nf = view.number_of_facets();
+    soup.points.clear();
+    soup.triangles.clear();
+    // 闭合三角网格中顶点数约为面数的一半
+    soup.points.reserve(nf / 2 + 3);
+    soup.triangles.reserve(nf);
+
+    std::unordered_map<Point_key, std::uint32_t, Point_key_hash> index_of;
+    index_of.reserve(nf / 2 + 3);
+
+    for (std::size_t f = 0; f < nf; ++f) {
+        std::array<std::uint32_t, 3> tri;
+        for (int j = 0; j < 3; ++j) {
+            float p[3];
+            view.vertex(f, j, p);
+            auto it = index_of.emplace(make_key(p), static_cast<std::uint32_t>(soup.points.size()));
+            if (it.second) {
+                soup.points.push_back({{p[0], p[1], p[2]}});
+            }
+            tri[j] = it.first->second;
+        }
+        soup.triangles.push_back(tri);
+    }
+}
+
+namespace {
+
+// ASCII 解析每块的最小字节数，过小的块线程开销大于收益
+const std::size_t ascii_min_chunk = std::size_t(1) << 20;
+
+inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; }
+
+// p 处是否为独立的 "vertex" 关键字
+inline bool is_vertex_keyword(const char* data, const char* p, const char* end) {
+    return end - p > 6 && std::memcmp(p, "vertex", 6) == 0 && is_space(p[6]) && (p == data || is_space(p[-1]));
+}
+
+// 解析关键字后的三个坐标，成功时返回其后的位置，失败返回 nullptr
+const char* parse_vertex(const char* p, const char* end, float* out) {
+    for (int i = 0; i < 3; ++i) {
+        while (p < end && is_space(*p)) {
+            ++p;
+        }
+        // from_chars 不接受前导正号
+        if (p < end && *p == '+') {
+            ++p;
+        }
+        std::from_chars_result r = std::from_chars(p, end, out[i]);
+        if (r.ec != std::errc()) {
+            return nullptr;
+        }
+        p = r.ptr;
+    }
+    return p;
+}
+
+// 解析起始字节落在 [begin, end) 内的所有 vertex 行；数值可以越过块尾，一直读到 limit
+bool parse_ascii_chunk(const char* data, const char* begin, const char* end, const char* limit,
+                       std::vector<float>& out) {
+    const char* p = begin;
+#if defined(__SSE2__)
+    const __m128i v = _mm_set1_epi8('v');
+    while (p + 16 <= end) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), v)));
+        if (mask == 0) {
+            p += 16;
+            continue;
+        }
+        const char* block = p;
+        p += 16;
+        while (mask != 0) {
+            const char* q = block + __builtin_ctz(mask);
+            mask &= mask - 1;
+            if (is_vertex_keyword(data, q, limit)) {
+                float c[3];
+                const char* next = parse_vertex(q + 6, limit, c);
+                if (next == nullptr) {
+                    return false;
+                }
+                out.insert(out.end(), c, c + 3);
+                // 跳过已解析的坐标，从其后继续扫描
+                if (next > p) {
+                    p = next;
+                    break;
+                }
+            }
+        }
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == 'v' && is_vertex_keyword(data, p, limit)) {
+            float c[3];
+            const char* next = parse_vertex(p + 6, limit, c);
+            if (next == nullptr) {
+                return false;
+            }
+            out.insert(out.end(), c, c + 3);
+            p = next - 1;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool parse_ascii_STL(const char* data, std::size_t size, std::vector<float>& corners, unsigned num_threads) {
+    corners.clear();
+    if (data == nullptr || size == 0) {
+        return false;
+    }
+    const unsigned chunks = parallel_chunk_count(size, num_threads, ascii_min_chunk);
+    std::vector<std::vector<float>> parts(chunks);
+    std::vector<char> ok(chunks, 0);
+    parallel_for(size, [&](std::size_t b, std::size_t e, unsigned t) {
+        // 按面片数估算：每个顶点行约 40 字节
+        parts[t].reserve((e - b) / 40 * 3);
+        ok[t] = parse_ascii_chunk(data, data + b, data + e, data + size, parts[t]);
+    }, num_threads, ascii_min_chunk);
+
+    std::vector<std::size_t> offset(chunks + 1, 0);
+    for (unsigned t = 0; t < chunks; ++t) {
+        if (!ok[t]) {
+            return false;
+        }
+        offset[t + 1] = offset[t] + parts[t].size();
+    }
+    if (offset[chunks] == 0 || offset[chunks] % 9 != 0) {
+        return false;
+    }
+    corners.resize(offset[chunks]);
+    parallel_for(chunks, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t t = b; t < e; ++t) {
+            std::copy(parts[t].begin(), parts[t].end(), corners.begin() + offset[t]);
+            std::vector<float>().swap(parts[t]);
+        }
+    }, num_threads, 1);
+    return true;
+}
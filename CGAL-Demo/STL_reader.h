@@ -0,0 +1,94 @@
+#ifndef LAR_STL_READER_H
+#define LAR_STL_READER_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 只读内存映射文件（RAII）：构造时 mmap，析构时 munmap
+class Mapped_file {
+public:
+    explicit Mapped_file(const std::string& filename);
+    ~Mapped_file();
+
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    bool is_open() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
+
+// 二进制 STL 面片视图：直接在映射内存上按 50 字节记录访问，不做拷贝
+// 记录布局：法向量 3*float + 三个顶点 9*float + 属性 uint16（小端）
+class Binary_STL_view {
+public:
+    static const std::size_t header_size = 84;
+    static const std::size_t facet_size = 50;
+
+    Binary_STL_view(const char* data, std::size_t size);
+
+    // 文件长度与头部记录的面片数一致时才认为是二进制 STL
+    bool is_valid() const { return valid_; }
+    std::size_t number_of_facets() const { return nb_facets_; }
+
+    const char* facet(std::size_t f) const { return data_ + header_size + f * facet_size; }
+    // 第 f 个面片的第 j 个顶点（j = 0, 1, 2），记录未对齐，用 memcpy 读取
+    void vertex(std::size_t f, int j, float out[3]) const {
+        std::memcpy(out, facet(f) + 12 + 12 * j, 3 * sizeof(float));
+    }
+
+private:
+    const char* data_;
+    std::size_t nb_facets_;
+    bool valid_;
+};
+
+// 三角形汤：STL 没有共享顶点，焊接后以索引形式保存
+struct STL_soup {
+    std::vector<std::array<float, 3>> points;
+    std::vector<std::array<std::uint32_t, 3>> triangles;
+};
+
+// 遍历映射内存中的面片，按坐标完全相同合并顶点
+void read_binary_STL(const Binary_STL_view& view, STL_soup& soup);
+
+// ASCII STL 快速解析：SSE2 每次扫描 16 字节定位 "vertex" 关键字，std::from_chars 转换坐标（与区域设置无关）
+// 大文件按字节切块多线程解析，各块结果按顺序拼接，与线程数无关
+// 成功时 corners 按面片顺序保存角点（每个面片 9 个 float）；
+// 没有找到顶点、顶点数不是 3 的倍数或坐标无法解析时返回 false，调用者可退回通用解析器
+bool parse_ascii_STL(const char* data, std::size_t size, std::vector<float>& corners, unsigned num_threads = 0);
+
+// 由三角形汤直接构建网格，预留顶点/面容量；返回被拒绝（退化或非流形）的面数
+template <typename Mesh>
+std::size_t soup_to_mesh(const STL_soup& soup, Mesh& mesh) {
+    typedef typename Mesh::Point Point;
+    typedef typename Mesh::Vertex_index Vertex_index;
+
+    mesh.reserve(static_cast<typename Mesh::size_type>(soup.points.size()),
+                 static_cast<typename Mesh::size_type>(3 * soup.triangles.size() / 2),
+                 static_cast<typename Mesh::size_type>(soup.triangles.size()));
+
+    std::vector<Vertex_index> vertices;
+    vertices.reserve(soup.points.size());
+    for (const auto& p : soup.points) {
+        vertices.push_back(mesh.add_vertex(Point(p[0], p[1], p[2])));
+    }
+
+    std::size_t rejected = 0;
+    for (const auto& t : soup.triangles) {
+        if (t[0] == t[1] || t[1] == t[2] || t[0] == t[2] ||
+            mesh.add_face(vertices[t[0]], vertices[t[1]], vertices[t[2]]) == Mesh::null_face()) {
+            ++rejected;
+        }
+    }
+    return rejected;
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "STL_writer.h"
+#include "STL_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const char stl_header[] = "LAR_STL binary STL";
+
+void scalar_normal(const float* c, float n[3]) {
+    const float ux = c[3] - c[0], uy = c[4] - c[1], uz = c[5] - c[2];
+    const float vx = c[6] - c[0], vy = c[7] - c[1], vz = c[8] - c[2];
+    n[0] = uy * vz - uz * vy;
+    n[1] = uz * vx - ux * vz;
+    n[2] = ux * vy - uy * vx;
+    const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    // 退化面片写零法向，与大多数读取器的约定一致
+    const float inv = len > 0 ? 1.0f / len : 0.0f;
+    n[0] *= inv;
+    n[1] *= inv;
+    n[2] *= inv;
+}
+
+void write_record(char* out, const float* corners, const float n[3]) {
+    std::memcpy(out, n, 12);
+    std::memcpy(out + 12, corners, 36);
+    out[48] = 0;
+    out[49] = 0;
+}
+
+// 把面片 [first, last) 的记录写到 out（out 指向面片 first 的记录）
+void fill_records(const float* corners, std::size_t first, std::size_t last, char* out) {
+    std::size_t f = first;
+#if defined(__SSE2__)
+    // 每次 4 个面片：把角点转置成 SoA 形式后并行算叉积、长度与归一化
+    for (; f + 4 <= last; f += 4) {
+        const float* c = corners + 9 * f;
+        __m128 a[3], b[3], d[3];
+        for (int k = 0; k < 3; ++k) {
+            a[k] = _mm_setr_ps(c[k], c[9 + k], c[18 + k], c[27 + k]);
+            b[k] = _mm_setr_ps(c[3 + k], c[12 + k], c[21 + k], c[30 + k]);
+            d[k] = _mm_setr_ps(c[6 + k], c[15 + k], c[24 + k], c[33 + k]);
+        }
+        __m128 u[3], v[3];
+        for (int k = 0; k < 3; ++k) {
+            u[k] = _mm_sub_ps(b[k], a[k]);
+            v[k] = _mm_sub_ps(d[k], a[k]);
+        }
+        __m128 n[3] = {_mm_sub_ps(_mm_mul_ps(u[1], v[2]), _mm_mul_ps(u[2], v[1])),
+                       _mm_sub_ps(_mm_mul_ps(u[2], v[0]), _mm_mul_ps(u[0], v[2])),
+                       _mm_sub_ps(_mm_mul_ps(u[0], v[1]), _mm_mul_ps(u[1], v[0]))};
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), _mm_mul_ps(n[1], n[1])),
+                                       _mm_mul_ps(n[2], n[2]));
+        // 长度为 0 的通道掩码成 0，避免 0/0 产生 NaN
+        const __m128 nonzero = _mm_cmpgt_ps(len2, _mm_setzero_ps());
+        const __m128 inv = _mm_and_ps(nonzero, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len2)));
+        float nx[4], ny[4], nz[4];
+        _mm_storeu_ps(nx, _mm_mul_ps(n[0], inv));
+        _mm_storeu_ps(ny, _mm_mul_ps(n[1], inv));
+        _mm_storeu_ps(nz, _mm_mul_ps(n[2], inv));
+        for (int l = 0; l < 4; ++l) {
+            const float normal[3] = {nx[l], ny[l], nz[l]};
+            write_record(out + (f + l - first) * Binary_STL_view::facet_size, c + 9 * l, normal);
+        }
+    }
+#endif
+    for (; f < last; ++f) {
+        float normal[3];
+        scalar_normal(corners + 9 * f, normal);
+        write_record(out + (f - first) * Binary_STL_view::facet_size, corners + 9 * f, normal);
+    }
+}
+
+void fill_header(char* out, std::uint32_t facets) {
+    std::memset(out, 0, 80);
+    std::memcpy(out, stl_header, sizeof(stl_header) - 1);
+    std::memcpy(out + 80, &facets, sizeof(facets));
+}
+
+// 退路：每次在缓冲中并行填好一大段记录，再顺序 fwrite
+bool write_buffered(const std::string& filename, const float* corners, std::size_t nf, unsigned num_threads) {
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    char header[Binary_STL_view::header_size];
+    fill_header(header, static_cast<std::uint32_t>(nf));
+    bool ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    const std::size_t block = std::size_t(1) << 18;
+    std::vector<char> buffer(std::min(nf, block) * Binary_STL_view::facet_size);
+    for (std::size_t first = 0; ok && first < nf; first += block) {
+        const std::size_t count = std::min(block, nf - first);
+        parallel_for(count, [&](std::size_t b, std::size_t e, unsigned) {
+            fill_records(corners, first + b, first + e, buffer.data() + b * Binary_STL_view::facet_size);
+        }, num_threads);
+        const std::size_t bytes = count * Binary_STL_view::facet_size;
+        ok = std::fwrite(buffer.data(), 1, bytes, file) == bytes;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace
+
+bool write_binary_STL_facets(const std::string& filename, const std::vector<float>& corners, unsigned num_threads) {
+    const std::size_t nf = corners.size() / 9;
+    if (nf > UINT32_MAX) {
+        return false;
+    }
+    const std::size_t size = Binary_STL_view::header_size + nf * Binary_STL_view::facet_size;
+
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* addr = MAP_FAILED;
+    // 只对普通文件预先分配磁盘块并映射：只设大小会得到稀疏文件，写映射时磁盘已满会触发 SIGBUS 而不是返回错误
+    // 分配失败（空间不足、文件系统不支持）以及管道、字符设备等都走缓冲写出，由 fwrite 报告错误
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0) {
+        addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return write_buffered(filename, corners.data(), nf, num_threads);
+    }
+
+    char* out = static_cast<char*>(addr);
+    fill_header(out, static_cast<std::uint32_t>(nf));
+    // 每条记录只依赖自己的角点，各线程写互不重叠的区间
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned) {
+        fill_records(corners.data(), b, e, out + Binary_STL_view::header_size + b * Binary_STL_view::facet_size);
+    }, num_threads);
+
+    const bool ok = ::munmap(addr, size) == 0;
+    return ::close(fd) == 0 && ok;
+}
+
+bool encode_binary_STL_facets(const std::vector<float>& corners, std::vector<char>& out, unsigned num_threads) {
+    const std::size_t nf = corners.size() / 9;
+    if (nf > UINT32_MAX) {
+        return false;
+    }
+    out.resize(Binary_STL_view::header_size + nf * Binary_STL_view::facet_size);
+    fill_header(out.data(), static_cast<std::uint32_t>(nf));
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned) {
+        fill_records(corners.data(), b, e, out.data() + Binary_STL_view::header_size + b * Binary_STL_view::facet_size);
+    }, num_threads);
+    return true;
+}
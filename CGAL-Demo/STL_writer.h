@@ -0,0 +1,63 @@
+#ifndef LAR_STL_WRITER_H
+#define LAR_STL_WRITER_H
+
+#include "Parallel.h"
+
+#include <CGAL/Surface_mesh.h>
+
+#include <string>
+#include <vector>
+
+// 把连续存放的面片角点（每个面片 9 个 float：三个顶点的 xyz）写成二进制 STL：
+// 法向用 SSE 每次计算 4 个面片的叉积并归一化，各线程直接填写预先分配好磁盘空间的内存映射文件；
+// 无法分配或映射（如空间不足、管道）时退化为按大块缓冲顺序写出，写失败返回 false
+bool write_binary_STL_facets(const std::string& filename, const std::vector<float>& corners,
+                             unsigned num_threads = 0);
+
+// 同上，但把完整的二进制 STL 文件内容编码到内存缓冲 out，由调用者自行写出（如异步 I/O）
+bool encode_binary_STL_facets(const std::vector<float>& corners, std::vector<char>& out, unsigned num_threads = 0);
+
+// 并行收集网格所有有效面的角点，每个面片 9 个 float
+template <typename Point>
+std::vector<float> gather_facet_corners(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Face_index Face_index;
+
+    // 没有垃圾时面索引连续，否则先收集有效面
+    std::vector<Face_index> faces;
+    if (mesh.has_garbage()) {
+        faces.assign(mesh.faces().begin(), mesh.faces().end());
+    }
+    const std::size_t nf = mesh.number_of_faces();
+
+    std::vector<float> corners(9 * nf);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) {
+            const Face_index f = faces.empty() ? Face_index(static_cast<typename Mesh::size_type>(i)) : faces[i];
+            auto h = mesh.halfedge(f);
+            float* out = &corners[9 * i];
+            for (int j = 0; j < 3; ++j) {
+                const Point& p = mesh.point(mesh.target(h));
+                out[3 * j] = static_cast<float>(CGAL::to_double(p.x()));
+                out[3 * j + 1] = static_cast<float>(CGAL::to_double(p.y()));
+                out[3 * j + 2] = static_cast<float>(CGAL::to_double(p.z()));
+                h = mesh.next(h);
+            }
+        }
+    }, num_threads);
+    return corners;
+}
+
+// 把三角网格写成二进制 STL：先并行收集所有面片角点到一块连续缓冲，再交给 write_binary_STL_facets
+template <typename Point>
+bool write_binary_STL(const std::string& filename, const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+    return write_binary_STL_facets(filename, gather_facet_corners(mesh, num_threads), num_threads);
+}
+
+// 把三角网格编码为内存中的二进制 STL 文件内容
+template <typename Point>
+bool encode_binary_STL(const CGAL::Surface_mesh<Point>& mesh, std::vector<char>& out, unsigned num_threads = 0) {
+    return encode_binary_STL_facets(gather_facet_corners(mesh, num_threads), out, num_threads);
+}
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef LAR_SELF_INTERSECTION_H
+#define LAR_SELF_INTERSECTION_H
+
+#include "Parallel.h"
+
+#include <CGAL/AABB_face_graph_triangle_primitive.h>
+#include <CGAL/AABB_traits.h>
+#include <CGAL/AABB_tree.h>
+#include <CGAL/Kernel_traits.h>
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/boost/graph/Euler_operations.h>
+#include <CGAL/Polygon_mesh_processing/border.h>
+#include <CGAL/Polygon_mesh_processing/triangulate_hole.h>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// 自相交修复结果
+struct Self_intersection_report {
+    // 第一轮检测到的自相交面对数
+    std::size_t intersecting_pairs = 0;
+    // 被删除后重新补洞的面数
+    std::size_t removed_faces = 0;
+    // 补洞失败的洞数
+    std::size_t unfilled_holes = 0;
+    // 超过边数上限、留给后续补洞阶段报告的洞数
+    std::size_t skipped_holes = 0;
+    // 修复后仍残留的自相交面对数
+    std::size_t remaining_pairs = 0;
+};
+
+namespace internal_self_intersection {
+
+template <typename Point>
+typename CGAL::Kernel_traits<Point>::Kernel::Triangle_3
+face_triangle(const CGAL::Surface_mesh<Point>& mesh, typename CGAL::Surface_mesh<Point>::Face_index f) {
+    auto h = mesh.halfedge(f);
+    return typename CGAL::Kernel_traits<Point>::Kernel::Triangle_3(
+        mesh.point(mesh.source(h)), mesh.point(mesh.target(h)), mesh.point(mesh.target(mesh.next(h))));
+}
+
+// 两个几何上相交的面是否真正自相交：相邻面共享顶点或边时需要单独判定
+template <typename Point>
+bool is_real_intersection(const CGAL::Surface_mesh<Point>& mesh, typename CGAL::Surface_mesh<Point>::Face_index f,
+                          typename CGAL::Surface_mesh<Point>::Face_index g) {
+    typedef typename CGAL::Kernel_traits<Point>::Kernel Kernel;
+    typedef typename CGAL::Surface_mesh<Point>::Vertex_index Vertex_index;
+
+    Vertex_index vf[3], vg[3];
+    auto hf = mesh.halfedge(f), hg = mesh.halfedge(g);
+    for (int i = 0; i < 3; ++i) {
+        vf[i] = mesh.target(hf);
+        vg[i] = mesh.target(hg);
+        hf = mesh.next(hf);
+        hg = mesh.next(hg);
+    }
+
+    int shared = 0, fi = -1, gi = -1;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            if (vf[i] == vg[j]) {
+                ++shared;
+                fi = i;
+                gi = j;
+            }
+
+    if (shared == 0 || shared == 3) {
+        return true;
+    }
+    if (shared == 2) {
+        // 共享一条边：只有两个对顶点与公共边共面且在同一侧时才重叠
+        int rf = 0, rg = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (vf[i] != vg[0] && vf[i] != vg[1] && vf[i] != vg[2]) rf = i;
+            if (vg[i] != vf[0] && vg[i] != vf[1] && vg[i] != vf[2]) rg = i;
+        }
+        const Point& p = mesh.point(vf[(rf + 1) % 3]);
+        const Point& q = mesh.point(vf[(rf + 2) % 3]);
+        const Point& r = mesh.point(vf[rf]);
+        const Point& s = mesh.point(vg[rg]);
+        return CGAL::coplanar(p, q, r, s) && CGAL::coplanar_orientation(p, q, r, s) == CGAL::POSITIVE;
+    }
+    // 共享一个顶点：检查各自的对边是否穿过另一个三角形
+    typename Kernel::Segment_3 sf(mesh.point(vf[(fi + 1) % 3]), mesh.point(vf[(fi + 2) % 3]));
+    typename Kernel::Segment_3 sg(mesh.point(vg[(gi + 1) % 3]), mesh.point(vg[(gi + 2) % 3]));
+    return CGAL::do_intersect(sf, face_triangle(mesh, g)) || CGAL::do_intersect(sg, face_triangle(mesh, f));
+}
+
+} // namespace internal_self_intersection
+
+// 用 AABB 树（包围体层次）找出所有自相交面对：树只建一次，之后各线程并行查询各自的面
+// 每对只在编号较小的面一侧记录，输出按面编号有序，与线程数无关
+template <typename Point>
+std::vector<std::pair<typename CGAL::Surface_mesh<Point>::Face_index, typename CGAL::Surface_mesh<Point>::Face_index>>
+find_self_intersections(const CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename CGAL::Kernel_traits<Point>::Kernel Kernel;
+    typedef typename Mesh::Face_index Face_index;
+    typedef CGAL::AABB_face_graph_triangle_primitive<Mesh> Primitive;
+    typedef CGAL::AABB_traits<Kernel, Primitive> Traits;
+    typedef CGAL::AABB_tree<Traits> Tree;
+
+    std::vector<Face_index> fs(mesh.faces().begin(), mesh.faces().end());
+    std::vector<std::pair<Face_index, Face_index>> pairs;
+    if (fs.size() < 2) {
+        return pairs;
+    }
+
+    Tree tree(fs.begin(), fs.end(), mesh);
+    // 显式建树，之后的查询是只读的，可以并发执行
+    tree.build();
+
+    const unsigned chunks = parallel_chunk_count(fs.size(), num_threads, 256);
+    std::vector<std::vector<std::pair<Face_index, Face_index>>> local(chunks);
+    parallel_for(fs.size(), [&](std::size_t b, std::size_t e, unsigned t) {
+        std::vector<Face_index> candidates;
+        for (std::size_t i = b; i < e; ++i) {
+            const Face_index f = fs[i];
+            candidates.clear();
+            tree.all_intersected_primitives(internal_self_intersection::face_triangle(mesh, f),
+                                            std::back_inserter(candidates));
+            std::sort(candidates.begin(), candidates.end());
+            for (Face_index g : candidates) {
+                if (f < g && internal_self_intersection::is_real_intersection(mesh, f, g)) {
+                    local[t].push_back(std::make_pair(f, g));
+                }
+            }
+        }
+    }, num_threads, 256);
+
+    for (const auto& l : local) {
+        pairs.insert(pairs.end(), l.begin(), l.end());
+    }
+    return pairs;
+}
+
+// 删除自相交区域（相交面及其一环邻域）并三角化、细化、光顺补洞，重复直到没有自相交或达到轮数上限
+// 只填补边全部由删除产生、且不超过 max_hole_edges 条边的洞
+template <typename Point>
+Self_intersection_report remove_self_intersections(CGAL::Surface_mesh<Point>& mesh, unsigned num_threads = 0,
+                                                   std::size_t max_hole_edges = 1000, int max_iterations = 5) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename Mesh::Face_index Face_index;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+    typedef typename Mesh::Edge_index Edge_index;
+
+    Self_intersection_report report;
+    auto pairs = find_self_intersections(mesh, num_threads);
+    report.intersecting_pairs = pairs.size();
+
+    for (int iteration = 0; iteration < max_iterations && !pairs.empty(); ++iteration) {
+        // 标记相交面及与其共享顶点的面，删除范围略大于相交区域，补洞后不易再次相交
+        std::vector<char> touched(mesh.num_vertices(), 0);
+        for (const auto& p : pairs) {
+            for (Face_index f : {p.first, p.second}) {
+                for (Vertex_index v : CGAL::vertices_around_face(mesh.halfedge(f), mesh)) {
+                    touched[v] = 1;
+                }
+            }
+        }
+        std::vector<Face_index> to_remove;
+        for (Face_index f : mesh.faces()) {
+            for (Vertex_index v : CGAL::vertices_around_face(mesh.halfedge(f), mesh)) {
+                if (touched[v]) {
+                    to_remove.push_back(f);
+                    break;
+                }
+            }
+        }
+        // 删除前已在边界上的边：经过这些边的环包含模型原有的开口，不由本阶段填补
+        std::vector<char> was_border(mesh.num_edges(), 0);
+        for (Edge_index e : mesh.edges()) {
+            was_border[e] = mesh.is_border(e);
+        }
+        for (Face_index f : to_remove) {
+            CGAL::Euler::remove_face(mesh.halfedge(f), mesh);
+        }
+        report.removed_faces += to_remove.size();
+
+        // 只填补完全由删除产生的边界环，且边数不超过 max_hole_edges；
+        // 与模型原有开口相连的环和过大的环留给后续补洞阶段处理与报告
+        std::vector<Halfedge_index> cycles;
+        CGAL::Polygon_mesh_processing::extract_boundary_cycles(mesh, std::back_inserter(cycles));
+        for (Halfedge_index h : cycles) {
+            bool created = true;
+            std::size_t edges = 0;
+            for (Halfedge_index c : CGAL::halfedges_around_face(h, mesh)) {
+                created = created && !was_border[mesh.edge(c)];
+                ++edges;
+            }
+            if (!created) {
+                continue;
+            }
+            if (edges > max_hole_edges) {
+                ++report.skipped_holes;
+                continue;
+            }
+            std::vector<Face_index> patch_faces;
+            std::vector<Vertex_index> patch_vertices;
+            bool ok = std::get<0>(CGAL::Polygon_mesh_processing::triangulate_refine_and_fair_hole(
+                mesh, h, std::back_inserter(patch_faces), std::back_inserter(patch_vertices)));
+            if (!ok) {
+                ++report.unfilled_holes;
+            }
+        }
+
+        pairs = find_self_intersections(mesh, num_threads);
+    }
+    report.remaining_pairs = pairs.size();
+    return report;
+}
+
+#endif
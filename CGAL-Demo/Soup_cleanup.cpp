@@ -0,0 +1,324 @@
+#include "Soup_cleanup.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+typedef std::array<std::uint32_t, 3> Triangle;
+
+enum Facet_state : unsigned char { keep = 0, degenerate = 1, duplicate = 2, sliver = 3 };
+
+// 顶点编号升序排列，同一组顶点的不同写法（轮换或翻转）得到同一个键
+Triangle sorted_key(const Triangle& t) {
+    Triangle k = t;
+    if (k[0] > k[1]) std::swap(k[0], k[1]);
+    if (k[1] > k[2]) std::swap(k[1], k[2]);
+    if (k[0] > k[1]) std::swap(k[0], k[1]);
+    return k;
+}
+
+struct Key_hash {
+    std::size_t operator()(const Triangle& k) const {
+        std::uint64_t h = static_cast<std::uint64_t>(k[0]) * 0x9E3779B97F4A7C15ull;
+        h ^= (static_cast<std::uint64_t>(k[1]) + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+        h ^= (static_cast<std::uint64_t>(k[2]) + 0x165667B19E3779F9ull) * 0x27D4EB2F165667C5ull;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+};
+
+enum Sliver_kind { not_sliver, needle, cap };
+
+// 三个顶点互不相同的面片：两倍面积不超过 tolerance * 最长边平方时为细长面片
+// 最短边长不超过 sqrt(tolerance) * 最长边长时为针状面片（含两个顶点坐标重合），corner 为最短边的起点；
+// 否则为帽状面片，对顶点几乎落在最长边上，corner 为最长边的起点
+Sliver_kind classify_sliver(const STL_soup& soup, const Triangle& t, double tolerance, int& corner) {
+    double p[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            p[i][k] = soup.points[t[i]][k];
+        }
+    }
+    double e[3][3], len2[3];
+    for (int i = 0; i < 3; ++i) {
+        const int j = (i + 1) % 3;
+        for (int k = 0; k < 3; ++k) {
+            e[i][k] = p[j][k] - p[i][k];
+        }
+        len2[i] = e[i][0] * e[i][0] + e[i][1] * e[i][1] + e[i][2] * e[i][2];
+    }
+    const double cx = e[0][1] * e[1][2] - e[0][2] * e[1][1];
+    const double cy = e[0][2] * e[1][0] - e[0][0] * e[1][2];
+    const double cz = e[0][0] * e[1][1] - e[0][1] * e[1][0];
+    int shortest = 0, longest = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (len2[i] < len2[shortest]) {
+            shortest = i;
+        }
+        if (len2[i] > len2[longest]) {
+            longest = i;
+        }
+    }
+    if (std::sqrt(cx * cx + cy * cy + cz * cz) > tolerance * len2[longest]) {
+        return not_sliver;
+    }
+    if (len2[shortest] <= tolerance * len2[longest]) {
+        corner = shortest;
+        return needle;
+    }
+    corner = longest;
+    return cap;
+}
+
+std::uint64_t edge_key(std::uint32_t a, std::uint32_t b) {
+    return a < b ? (static_cast<std::uint64_t>(a) << 32 | b) : (static_cast<std::uint64_t>(b) << 32 | a);
+}
+
+std::uint32_t find_root(std::vector<std::uint32_t>& parent, std::uint32_t v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+// 帽状面片：最长边 a -> b，对顶点 c 落在其上
+struct Cap {
+    std::uint32_t facet, a, b, c;
+};
+
+// 删除帽状面片，并在 c 处把 ab 另一侧的面片一分为二（等价于翻转边 ab），曲面不移动、保持闭合
+// 只处理 ab 另一侧恰好有一个普通面片、且该面片本轮未被拆分的情形，其余帽状面片保留原样；按面片顺序串行处理
+std::size_t split_caps(STL_soup& soup, std::vector<unsigned char>& state, const std::vector<Cap>& caps,
+                       unsigned num_threads) {
+    if (caps.empty()) {
+        return 0;
+    }
+    const std::uint32_t shared = std::numeric_limits<std::uint32_t>::max();
+    std::unordered_map<std::uint64_t, std::uint32_t> cap_of;
+    cap_of.reserve(2 * caps.size());
+    for (std::uint32_t i = 0; i < caps.size(); ++i) {
+        auto r = cap_of.emplace(edge_key(caps[i].a, caps[i].b), i);
+        if (!r.second) {
+            r.first->second = shared;
+        }
+    }
+
+    // 并行查找最长边另一侧的面片，分块内按面片顺序记录
+    std::vector<Triangle>& triangles = soup.triangles;
+    const std::size_t nf = triangles.size();
+    const unsigned chunks = parallel_chunk_count(nf, num_threads);
+    std::vector<std::vector<std::array<std::uint32_t, 2>>> matches(chunks);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+        for (std::size_t f = b; f < e; ++f) {
+            if (state[f] != keep) {
+                continue;
+            }
+            const Triangle& tri = triangles[f];
+            for (int i = 0; i < 3; ++i) {
+                auto it = cap_of.find(edge_key(tri[i], tri[(i + 1) % 3]));
+                if (it != cap_of.end()) {
+                    matches[t].push_back({it->second, static_cast<std::uint32_t>(f)});
+                }
+            }
+        }
+    }, num_threads);
+
+    std::vector<std::uint32_t> neighbour(caps.size(), shared), nb_neighbours(caps.size(), 0);
+    for (const auto& m : matches) {
+        for (const auto& cf : m) {
+            if (cf[0] != shared) {
+                neighbour[cf[0]] = cf[1];
+                ++nb_neighbours[cf[0]];
+            }
+        }
+    }
+
+    std::unordered_set<std::uint32_t> split;
+    std::size_t nb_split = 0;
+    for (std::uint32_t i = 0; i < caps.size(); ++i) {
+        const Cap& c = caps[i];
+        const std::uint32_t f = neighbour[i];
+        if (nb_neighbours[i] != 1 || !split.insert(f).second) {
+            state[c.facet] = keep;
+            continue;
+        }
+        const Triangle n = triangles[f];
+        int k = 0;
+        while (edge_key(n[k], n[(k + 1) % 3]) != edge_key(c.a, c.b)) {
+            ++k;
+        }
+        // 保持该面片原有的朝向：u -> v 之间插入 c
+        const std::uint32_t u = n[k], v = n[(k + 1) % 3], x = n[(k + 2) % 3];
+        triangles[f] = Triangle{{u, c.c, x}};
+        triangles.push_back(Triangle{{c.c, v, x}});
+        state.push_back(keep);
+        ++nb_split;
+    }
+    return nb_split;
+}
+
+// 针状面片合并最短边并对全部面片重新编号；合并对很少，按面片顺序串行合并，结果与线程数无关
+void collapse_needles(STL_soup& soup, const std::vector<std::vector<std::array<std::uint32_t, 2>>>& pairs,
+                      unsigned num_threads) {
+    // 并查集以编号最小的顶点为根
+    std::vector<std::uint32_t> parent(soup.points.size());
+    std::iota(parent.begin(), parent.end(), 0u);
+    for (const auto& p : pairs) {
+        for (const auto& uv : p) {
+            const std::uint32_t ru = find_root(parent, uv[0]);
+            const std::uint32_t rv = find_root(parent, uv[1]);
+            if (ru < rv) {
+                parent[rv] = ru;
+            } else if (rv < ru) {
+                parent[ru] = rv;
+            }
+        }
+    }
+    // 路径折半不保证链上每个顶点都直接指向根，这里把所有参与合并的顶点逐个指向根；
+    // 其余顶点从未参与合并，父节点仍是自身，重新编号只读 parent
+    for (const auto& p : pairs) {
+        for (const auto& uv : p) {
+            parent[uv[0]] = find_root(parent, uv[0]);
+            parent[uv[1]] = find_root(parent, uv[1]);
+        }
+    }
+    std::vector<Triangle>& triangles = soup.triangles;
+    parallel_for(triangles.size(), [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t f = b; f < e; ++f) {
+            for (std::uint32_t& v : triangles[f]) {
+                v = parent[v];
+            }
+        }
+    }, num_threads);
+}
+
+// 找出细长面片：帽状面片先拆分其最长边另一侧的面片，再合并针状面片的最短边
+void remove_slivers(STL_soup& soup, std::vector<unsigned char>& state, double tolerance, unsigned num_threads,
+                    Soup_cleanup_report& report) {
+    const std::vector<Triangle>& triangles = soup.triangles;
+    const std::size_t nf = triangles.size();
+    const unsigned chunks = parallel_chunk_count(nf, num_threads);
+    std::vector<std::vector<std::array<std::uint32_t, 2>>> pairs(chunks);
+    std::vector<std::vector<Cap>> caps(chunks);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+        for (std::size_t f = b; f < e; ++f) {
+            const Triangle& tri = triangles[f];
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                continue;
+            }
+            int i = 0;
+            const Sliver_kind kind = classify_sliver(soup, tri, tolerance, i);
+            if (kind == needle) {
+                state[f] = sliver;
+                pairs[t].push_back({tri[i], tri[(i + 1) % 3]});
+            } else if (kind == cap) {
+                state[f] = sliver;
+                caps[t].push_back(Cap{static_cast<std::uint32_t>(f), tri[i], tri[(i + 1) % 3], tri[(i + 2) % 3]});
+            }
+        }
+    }, num_threads);
+
+    std::vector<Cap> all_caps;
+    for (const auto& c : caps) {
+        all_caps.insert(all_caps.end(), c.begin(), c.end());
+    }
+    report.split_caps = split_caps(soup, state, all_caps, num_threads);
+    for (const auto& p : pairs) {
+        report.collapsed_slivers += p.size();
+    }
+    if (report.collapsed_slivers > 0) {
+        collapse_needles(soup, pairs, num_threads);
+    }
+}
+
+} // namespace
+
+Soup_cleanup_report clean_STL_soup(STL_soup& soup, unsigned num_threads, double sliver_tolerance) {
+    Soup_cleanup_report report;
+    if (soup.triangles.empty()) {
+        return report;
+    }
+    std::vector<unsigned char> state(soup.triangles.size(), keep);
+    remove_slivers(soup, state, sliver_tolerance, num_threads, report);
+
+    // 拆分帽状面片可能追加了面片
+    const std::size_t nf = soup.triangles.size();
+    const std::vector<Triangle>& triangles = soup.triangles;
+    const unsigned chunks = parallel_chunk_count(nf, num_threads);
+    const std::size_t nb_shards = 4 * static_cast<std::size_t>(chunks);
+
+    // 退化判定与按哈希分片同在一遍内完成，已塌缩的细长面片单独计数
+    std::vector<std::vector<std::vector<std::uint32_t>>> buckets(chunks,
+                                                                 std::vector<std::vector<std::uint32_t>>(nb_shards));
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+        for (std::size_t f = b; f < e; ++f) {
+            const Triangle& tri = triangles[f];
+            if (state[f] == sliver) {
+                continue;
+            }
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                state[f] = degenerate;
+            } else {
+                buckets[t][Key_hash()(sorted_key(tri)) % nb_shards].push_back(static_cast<std::uint32_t>(f));
+            }
+        }
+    }, num_threads);
+
+    // 分片内按线程序号、面片序号依次插入，先插入者即编号最小的面片
+    parallel_for(nb_shards, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t s = b; s < e; ++s) {
+            std::size_t total = 0;
+            for (unsigned t = 0; t < chunks; ++t) {
+                total += buckets[t][s].size();
+            }
+            std::unordered_set<Triangle, Key_hash> seen;
+            seen.reserve(total);
+            for (unsigned t = 0; t < chunks; ++t) {
+                for (std::uint32_t f : buckets[t][s]) {
+                    if (!seen.insert(sorted_key(triangles[f])).second) {
+                        state[f] = duplicate;
+                    }
+                }
+                std::vector<std::uint32_t>().swap(buckets[t][s]);
+            }
+        }
+    }, num_threads, 1);
+
+    // 分块统计保留数量，前缀和得到各块的写出位置
+    std::vector<std::size_t> counts(chunks + 1, 0);
+    std::vector<std::size_t> degenerate_counts(chunks, 0), duplicate_counts(chunks, 0);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+        for (std::size_t f = b; f < e; ++f) {
+            counts[t + 1] += state[f] == keep;
+            degenerate_counts[t] += state[f] == degenerate;
+            duplicate_counts[t] += state[f] == duplicate;
+        }
+    }, num_threads);
+    for (unsigned t = 0; t < chunks; ++t) {
+        counts[t + 1] += counts[t];
+        report.degenerate_facets += degenerate_counts[t];
+        report.duplicate_facets += duplicate_counts[t];
+    }
+    if (counts[chunks] == nf) {
+        return report;
+    }
+
+    std::vector<Triangle> kept(counts[chunks]);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+        std::size_t next = counts[t];
+        for (std::size_t f = b; f < e; ++f) {
+            if (state[f] == keep) {
+                kept[next++] = triangles[f];
+            }
+        }
+    }, num_threads);
+    soup.triangles.swap(kept);
+    return report;
+}
@@ -0,0 +1,29 @@
+#ifndef LAR_SOUP_CLEANUP_H
+#define LAR_SOUP_CLEANUP_H
+
+#include "STL_reader.h"
+
+// 三角形汤清理结果
+struct Soup_cleanup_report {
+    // 顶点集合与先前某个面片相同的面片（不论朝向）
+    std::size_t duplicate_facets = 0;
+    // 焊接后有两个角点落在同一顶点、已塌缩成线段或点的面片
+    std::size_t degenerate_facets = 0;
+    // 三个顶点互不相同、面积近零且有一条极短边的针状面片，该短边已塌缩
+    std::size_t collapsed_slivers = 0;
+    // 对顶点落在最长边上的帽状面片，已删除并在对顶点处拆分最长边另一侧的面片
+    std::size_t split_caps = 0;
+};
+
+// 在建网格前删除重复与退化面片，后续的非流形顶点复制与边界缝合只处理干净的面
+// 0. 并行找出面积不超过 sliver_tolerance * 最长边平方 的细长面片：
+//    帽状面片（三条边都不短，对顶点落在最长边上）删除，并在对顶点处把最长边另一侧的面片一分为二，几何不变；
+//    针状面片（最短边不超过 sqrt(sliver_tolerance) * 最长边）合并最短边的两个顶点（保留编号较小者），
+//    全部面片按合并结果重新编号，针状面片与共享该短边的面片随之退化并被删除
+// 1. 并行判定退化面片，并为其余面片计算排序后顶点编号的哈希（与角点顺序、朝向无关）
+// 2. 按哈希分片，每个分片由一个线程按面片编号顺序建表，首次出现的面片保留
+// 3. 按分块前缀和并行压缩，保留的面片维持原有顺序
+// 结果只取决于输入，与线程数无关；未被引用的顶点留给后续的孤立顶点移除
+Soup_cleanup_report clean_STL_soup(STL_soup& soup, unsigned num_threads = 0, double sliver_tolerance = 1e-6);
+
+#endif
@@ -0,0 +1,226 @@
+#include "Soup_orientation.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace {
+
+typedef std::array<std::uint32_t, 3> Triangle;
+
+const std::uint32_t invalid = std::numeric_limits<std::uint32_t>::max();
+// 前沿小于该规模时在当前线程展开，避免小分量为每层启动线程
+const std::size_t frontier_chunk = 1024;
+// 有向体积按 BFS 顺序每这么多个面片累加一次，分块与线程数无关，浮点结果可复现
+const std::size_t volume_block = 4096;
+
+// 无向边：key 高 32 位为较小的顶点编号；half = 3 * 面片 + 边序号，边 k 从角点 k 指向角点 k+1
+struct Edge_entry {
+    std::uint64_t key;
+    std::uint32_t half;
+};
+
+bool same_edge(const Edge_entry& x, const Edge_entry& y) { return x.key == y.key; }
+
+// 原子地把 slot 降为 min(slot, f)
+void claim(std::atomic<std::uint32_t>& slot, std::uint32_t f) {
+    std::uint32_t current = slot.load(std::memory_order_relaxed);
+    while (f < current && !slot.compare_exchange_weak(current, f, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+Soup_orientation_report orient_STL_soup(STL_soup& soup, unsigned num_threads) {
+    Soup_orientation_report report;
+    std::vector<Triangle>& triangles = soup.triangles;
+    const std::size_t nf = triangles.size();
+    if (nf == 0) {
+        return report;
+    }
+    const std::size_t nh = 3 * nf;
+    auto source = [&](std::uint32_t h) { return triangles[h / 3][h % 3]; };
+
+    // 1. 排序后相邻的相同边即共享该边的面片，恰好两个时互为对边
+    std::vector<std::uint32_t> opposite(nh, invalid);
+    {
+        std::vector<Edge_entry> entries(nh);
+        parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t f = b; f < e; ++f) {
+                for (int k = 0; k < 3; ++k) {
+                    const std::uint32_t u = triangles[f][k], v = triangles[f][(k + 1) % 3];
+                    entries[3 * f + k] = {(std::uint64_t(std::min(u, v)) << 32) | std::max(u, v),
+                                          static_cast<std::uint32_t>(3 * f + k)};
+                }
+            }
+        }, num_threads);
+        parallel_sort(entries.begin(), entries.end(), [](const Edge_entry& x, const Edge_entry& y) {
+            return x.key != y.key ? x.key < y.key : x.half < y.half;
+        }, num_threads);
+        parallel_for(nh, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t i = b; i < e; ++i) {
+                if (i > 0 && same_edge(entries[i - 1], entries[i])) {
+                    continue;
+                }
+                if (i + 1 < nh && same_edge(entries[i], entries[i + 1]) &&
+                    (i + 2 >= nh || !same_edge(entries[i], entries[i + 2]))) {
+                    opposite[entries[i].half] = entries[i + 1].half;
+                    opposite[entries[i + 1].half] = entries[i].half;
+                }
+            }
+        }, num_threads);
+    }
+
+    // 2. 逐分量 BFS；order 按分量、按层保存访问顺序，component_begin 为各分量在其中的起点
+    std::unique_ptr<std::atomic<std::uint32_t>[]> parent(new std::atomic<std::uint32_t>[nf]);
+    parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t f = b; f < e; ++f) {
+            parent[f].store(invalid, std::memory_order_relaxed);
+        }
+    }, num_threads);
+    std::vector<unsigned char> visited(nf, 0), flip(nf, 0);
+    std::vector<std::uint32_t> order;
+    order.reserve(nf);
+    std::vector<std::size_t> component_begin;
+    std::vector<std::vector<std::uint32_t>> next(resolve_thread_count(num_threads));
+    std::vector<std::size_t> offsets;
+
+    for (std::size_t root = 0; root < nf; ++root) {
+        if (visited[root]) {
+            continue;
+        }
+        component_begin.push_back(order.size());
+        visited[root] = 1;
+        order.push_back(static_cast<std::uint32_t>(root));
+        std::size_t level_begin = order.size() - 1;
+        while (level_begin < order.size()) {
+            const std::size_t level_end = order.size();
+            const std::size_t n = level_end - level_begin;
+            // 前沿面片竞争未访问的邻居，编号最小者胜出
+            parallel_for(n, [&](std::size_t b, std::size_t e, unsigned) {
+                for (std::size_t i = b; i < e; ++i) {
+                    const std::uint32_t f = order[level_begin + i];
+                    for (int k = 0; k < 3; ++k) {
+                        const std::uint32_t o = opposite[3 * f + k];
+                        if (o != invalid && !visited[o / 3]) {
+                            claim(parent[o / 3], f);
+                        }
+                    }
+                }
+            }, num_threads, frontier_chunk);
+
+            // 胜出的父面片按前沿顺序收集子面片并确定其朝向：共享边同向说明两者朝向相反
+            const unsigned chunks = parallel_chunk_count(n, num_threads, frontier_chunk);
+            parallel_for(n, [&](std::size_t b, std::size_t e, unsigned t) {
+                std::vector<std::uint32_t>& out = next[t];
+                out.clear();
+                for (std::size_t i = b; i < e; ++i) {
+                    const std::uint32_t f = order[level_begin + i];
+                    for (int k = 0; k < 3; ++k) {
+                        const std::uint32_t h = 3 * f + k;
+                        const std::uint32_t o = opposite[h];
+                        if (o == invalid || visited[o / 3] || parent[o / 3].load(std::memory_order_relaxed) != f) {
+                            continue;
+                        }
+                        // 两个面片共享多条边时只由第一条边收集一次
+                        bool first = true;
+                        for (int j = 0; j < k; ++j) {
+                            first = first && (opposite[3 * f + j] == invalid || opposite[3 * f + j] / 3 != o / 3);
+                        }
+                        if (first) {
+                            flip[o / 3] = flip[f] ^ static_cast<unsigned char>(source(h) == source(o));
+                            out.push_back(o / 3);
+                        }
+                    }
+                }
+            }, num_threads, frontier_chunk);
+
+            offsets.assign(chunks + 1, level_end);
+            for (unsigned t = 0; t < chunks; ++t) {
+                offsets[t + 1] = offsets[t] + next[t].size();
+            }
+            order.resize(offsets[chunks]);
+            parallel_for(chunks, [&](std::size_t b, std::size_t e, unsigned) {
+                for (std::size_t t = b; t < e; ++t) {
+                    std::size_t at = offsets[t];
+                    for (std::uint32_t g : next[t]) {
+                        visited[g] = 1;
+                        order[at++] = g;
+                    }
+                }
+            }, num_threads, 1);
+            level_begin = level_end;
+        }
+    }
+    parent.reset();
+    report.components = component_begin.size();
+    component_begin.push_back(nf);
+
+    // 3. 有向体积：每块对 p0 · (p1 × p2) 求和，同时检查分量是否封闭
+    struct Volume_task {
+        std::size_t begin, end, component;
+        double volume;
+        bool closed;
+    };
+    std::vector<Volume_task> tasks;
+    for (std::size_t c = 0; c + 1 < component_begin.size(); ++c) {
+        for (std::size_t b = component_begin[c]; b < component_begin[c + 1]; b += volume_block) {
+            tasks.push_back({b, std::min(component_begin[c + 1], b + volume_block), c, 0.0, true});
+        }
+    }
+    parallel_for(tasks.size(), [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) {
+            Volume_task& task = tasks[i];
+            for (std::size_t j = task.begin; j < task.end; ++j) {
+                const std::uint32_t f = order[j];
+                const Triangle& t = triangles[f];
+                const std::array<float, 3>& p = soup.points[t[0]];
+                const std::array<float, 3>& q = soup.points[flip[f] ? t[2] : t[1]];
+                const std::array<float, 3>& r = soup.points[flip[f] ? t[1] : t[2]];
+                task.volume += double(p[0]) * (double(q[1]) * r[2] - double(q[2]) * r[1]) +
+                               double(p[1]) * (double(q[2]) * r[0] - double(q[0]) * r[2]) +
+                               double(p[2]) * (double(q[0]) * r[1] - double(q[1]) * r[0]);
+                for (int k = 0; k < 3; ++k) {
+                    task.closed = task.closed && opposite[3 * f + k] != invalid;
+                }
+            }
+        }
+    }, num_threads, 16);
+
+    std::vector<unsigned char> invert(report.components, 0);
+    for (std::size_t i = 0; i < tasks.size();) {
+        const std::size_t c = tasks[i].component;
+        double volume = 0.0;
+        bool closed = true;
+        for (; i < tasks.size() && tasks[i].component == c; ++i) {
+            volume += tasks[i].volume;
+            closed = closed && tasks[i].closed;
+        }
+        if (closed && volume < 0.0) {
+            invert[c] = 1;
+            ++report.inverted_shells;
+        }
+    }
+
+    // 翻转：交换角点 1 与 2
+    std::vector<std::size_t> flipped(parallel_chunk_count(tasks.size(), num_threads, 16), 0);
+    parallel_for(tasks.size(), [&](std::size_t b, std::size_t e, unsigned t) {
+        for (std::size_t i = b; i < e; ++i) {
+            const Volume_task& task = tasks[i];
+            for (std::size_t j = task.begin; j < task.end; ++j) {
+                const std::uint32_t f = order[j];
+                if (flip[f] ^ invert[task.component]) {
+                    std::swap(triangles[f][1], triangles[f][2]);
+                    ++flipped[t];
+                }
+            }
+        }
+    }, num_threads, 16);
+    for (std::size_t n : flipped) {
+        report.flipped_facets += n;
+    }
+    return report;
+}
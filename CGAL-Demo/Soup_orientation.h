@@ -0,0 +1,24 @@
+#ifndef LAR_SOUP_ORIENTATION_H
+#define LAR_SOUP_ORIENTATION_H
+
+#include "STL_reader.h"
+
+// 三角形汤定向结果
+struct Soup_orientation_report {
+    // 经由流形边（恰好两个面片共享的边）相连的面片分量数
+    std::size_t components = 0;
+    // 最终被翻转的面片数
+    std::size_t flipped_facets = 0;
+    // 有向体积为负、整体翻转为朝外的封闭壳体数
+    std::size_t inverted_shells = 0;
+};
+
+// 在建网格前统一面片朝向，避免翻转的面片在建网格时被拒绝、在缝合时留下非流形结构
+// 1. 对所有边排序建立面片邻接，只有恰好两个面片共享的边参与传播
+// 2. 按面片编号依次选取未访问的面片为根做 BFS，每层前沿并行展开；同一面片被多个前沿面片触及时
+//    取编号最小者为父，朝向由父面片与共享边的方向决定
+// 3. 所有边都有邻居的分量为封闭壳体，按固定大小分块累加有向体积，为负则整体翻转
+// 结果只取决于输入，与线程数无关
+Soup_orientation_report orient_STL_soup(STL_soup& soup, unsigned num_threads = 0);
+
+#endif
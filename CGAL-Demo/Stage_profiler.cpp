@@ -0,0 +1,95 @@
+#include "Stage_profiler.h"
+
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <ostream>
+
+namespace {
+
+double process_cpu_seconds() {
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + 1e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+} // namespace
+
+Stage_profiler::Stage_profiler() : cpu_start_(0.0), rss_start_(0), running_(false) {}
+
+long long Stage_profiler::peak_rss() {
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    // Linux 上 ru_maxrss 的单位是 KB
+    return static_cast<long long>(usage.ru_maxrss) * 1024;
+}
+
+void Stage_profiler::start(const std::string& name) {
+    Stage_record record;
+    record.name = name;
+    stages_.push_back(record);
+    rss_start_ = peak_rss();
+    cpu_start_ = process_cpu_seconds();
+    wall_start_ = std::chrono::steady_clock::now();
+    running_ = true;
+}
+
+void Stage_profiler::stop(std::size_t vertices, std::size_t faces) {
+    if (!running_) {
+        return;
+    }
+    Stage_record& record = stages_.back();
+    record.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start_).count();
+    record.cpu_seconds = process_cpu_seconds() - cpu_start_;
+    record.peak_rss_delta = peak_rss() - rss_start_;
+    record.vertices = vertices;
+    record.faces = faces;
+    running_ = false;
+}
+
+double Stage_profiler::total_wall_seconds() const {
+    double total = 0.0;
+    for (const Stage_record& s : stages_) {
+        total += s.wall_seconds;
+    }
+    return total;
+}
+
+void Stage_profiler::write_json(std::ostream& os) const {
+    os << "[";
+    for (std::size_t i = 0; i < stages_.size(); ++i) {
+        const Stage_record& s = stages_[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << json_quote(s.name)
+           << ", \"wall_seconds\": " << s.wall_seconds << ", \"cpu_seconds\": " << s.cpu_seconds
+           << ", \"peak_rss_delta\": " << s.peak_rss_delta << ", \"vertices\": " << s.vertices
+           << ", \"faces\": " << s.faces << "}";
+    }
+    os << (stages_.empty() ? "]" : "\n  ]");
+}
+
+std::string json_quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += "\"";
+    return out;
+}
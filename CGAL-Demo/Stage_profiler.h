@@ -0,0 +1,50 @@
+#ifndef LAR_STAGE_PROFILER_H
+#define LAR_STAGE_PROFILER_H
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// 单个阶段的计量结果
+struct Stage_record {
+    std::string name;
+    // 墙钟时间
+    double wall_seconds = 0.0;
+    // 进程 CPU 时间（用户态 + 内核态，包含所有工作线程）
+    double cpu_seconds = 0.0;
+    // 该阶段使进程峰值常驻内存增长的字节数
+    long long peak_rss_delta = 0;
+    // 阶段结束时的元素数量
+    std::size_t vertices = 0;
+    std::size_t faces = 0;
+};
+
+// 修复流程的分阶段计量：start 与 stop 成对调用，不支持嵌套
+class Stage_profiler {
+public:
+    Stage_profiler();
+
+    void start(const std::string& name);
+    void stop(std::size_t vertices, std::size_t faces);
+
+    const std::vector<Stage_record>& stages() const { return stages_; }
+    double total_wall_seconds() const;
+    // 进程当前的峰值常驻内存（字节）
+    static long long peak_rss();
+
+    // 输出 JSON 数组，每个阶段一个对象，字段名与 Stage_record 一致
+    void write_json(std::ostream& os) const;
+
+private:
+    std::vector<Stage_record> stages_;
+    std::chrono::steady_clock::time_point wall_start_;
+    double cpu_start_;
+    long long rss_start_;
+    bool running_;
+};
+
+// 把字符串按 JSON 规则加引号并转义
+std::string json_quote(const std::string& s);
+
+#endif
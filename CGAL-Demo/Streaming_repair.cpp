@@ -0,0 +1,627 @@
+#include "Streaming_repair.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+// 每个轴上的直方图格子数
+const int bins = 64;
+// 修复一个面片大致需要的内存：溢写缓冲、三角形汤、焊接表与 Surface_mesh
+const std::size_t bytes_per_facet = 400;
+// 同时打开的溢写文件数上限
+const std::size_t max_open_spills = 256;
+// 溢写记录：原始面片编号 + 三个顶点
+const std::size_t spill_record_size = 4 + 36;
+
+typedef std::array<float, 3> Point3f;
+
+// 直方图格子区间 [lo, hi)
+struct Bin_range {
+    int lo[3];
+    int hi[3];
+};
+
+// 包围盒上的均匀直方图网格
+class Grid {
+public:
+    void init(const double lo[3], const double hi[3]) {
+        for (int i = 0; i < 3; ++i) {
+            double extent = hi[i] - lo[i];
+            lo_[i] = lo[i];
+            size_[i] = (extent > 0 ? extent : 1.0) / bins;
+        }
+    }
+    int bin(int axis, double x) const {
+        int b = static_cast<int>(std::floor((x - lo_[axis]) / size_[axis]));
+        return std::max(0, std::min(bins - 1, b));
+    }
+    double coord(int axis, int b) const { return lo_[axis] + b * size_[axis]; }
+    double size(int axis) const { return size_[axis]; }
+    static std::size_t flat(int x, int y, int z) { return (static_cast<std::size_t>(x) * bins + y) * bins + z; }
+
+private:
+    double lo_[3];
+    double size_[3];
+};
+
+void facet_points(const Binary_STL_view& view, std::size_t f, float p[3][3]) {
+    for (int j = 0; j < 3; ++j) {
+        view.vertex(f, j, p[j]);
+    }
+}
+
+std::uint64_t count_in(const std::vector<std::uint64_t>& hist, const Bin_range& r) {
+    std::uint64_t n = 0;
+    for (int x = r.lo[0]; x < r.hi[0]; ++x)
+        for (int y = r.lo[1]; y < r.hi[1]; ++y)
+            for (int z = r.lo[2]; z < r.hi[2]; ++z)
+                n += hist[Grid::flat(x, y, z)];
+    return n;
+}
+
+// 沿几何尺寸最长的轴在面片数中位处切分，直到每块面片数不超过上限
+void split(const std::vector<std::uint64_t>& hist, const Grid& grid, const Bin_range& r,
+           std::uint64_t max_facets, std::vector<Bin_range>& leaves) {
+    const std::uint64_t n = count_in(hist, r);
+    if (n == 0) {
+        return;
+    }
+    int axis = -1;
+    double widest = 0;
+    for (int i = 0; i < 3; ++i) {
+        double w = (r.hi[i] - r.lo[i]) * grid.size(i);
+        if (r.hi[i] - r.lo[i] > 1 && w > widest) {
+            widest = w;
+            axis = i;
+        }
+    }
+    if (n <= max_facets || axis < 0) {
+        leaves.push_back(r);
+        return;
+    }
+
+    int cut = r.lo[axis] + 1;
+    std::uint64_t acc = 0;
+    for (int s = r.lo[axis]; s < r.hi[axis] - 1; ++s) {
+        Bin_range slab = r;
+        slab.lo[axis] = s;
+        slab.hi[axis] = s + 1;
+        acc += count_in(hist, slab);
+        cut = s + 1;
+        if (2 * acc >= n) {
+            break;
+        }
+    }
+    Bin_range left = r, right = r;
+    left.hi[axis] = cut;
+    right.lo[axis] = cut;
+    split(hist, grid, left, max_facets, leaves);
+    split(hist, grid, right, max_facets, leaves);
+}
+
+// 增量写出二进制 STL：先写占位头，结束时回填面片数
+class STL_append_writer {
+public:
+    STL_append_writer() : file_(nullptr), count_(0), ok_(true) {}
+    ~STL_append_writer() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+        }
+    }
+    bool open(const std::string& filename) {
+        file_ = std::fopen(filename.c_str(), "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        char header[Binary_STL_view::header_size] = "LAR_STL streaming repair";
+        return std::fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+    }
+    // 写入不完整时不计数，并使 close 失败，文件头不会声明未写出的面片
+    bool write(const Point3f p[3]) {
+        if (!ok_) {
+            return false;
+        }
+        float n[3] = {(p[1][1] - p[0][1]) * (p[2][2] - p[0][2]) - (p[1][2] - p[0][2]) * (p[2][1] - p[0][1]),
+                      (p[1][2] - p[0][2]) * (p[2][0] - p[0][0]) - (p[1][0] - p[0][0]) * (p[2][2] - p[0][2]),
+                      (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0])};
+        float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len > 0) {
+            n[0] /= len;
+            n[1] /= len;
+            n[2] /= len;
+        }
+        char record[Binary_STL_view::facet_size] = {0};
+        std::memcpy(record, n, 12);
+        for (int j = 0; j < 3; ++j) {
+            std::memcpy(record + 12 + 12 * j, p[j].data(), 12);
+        }
+        if (std::fwrite(record, 1, sizeof(record), file_) != sizeof(record)) {
+            ok_ = false;
+            return false;
+        }
+        ++count_;
+        return true;
+    }
+    bool close() {
+        bool ok = ok_ && std::fseek(file_, 80, SEEK_SET) == 0 && std::fwrite(&count_, 4, 1, file_) == 1;
+        ok = (std::fclose(file_) == 0) && ok;
+        file_ = nullptr;
+        return ok;
+    }
+    std::uint32_t count() const { return count_; }
+    bool is_open() const { return file_ != nullptr; }
+
+private:
+    std::FILE* file_;
+    std::uint32_t count_;
+    bool ok_;
+};
+
+// 接缝登记表：记录已输出的边界附近顶点，后续分块中相近的顶点吸附到同一位置
+// 每个顶点记下最后一个可能吸附到它的分块，该分块输出后即删除，占用只取决于尚未输出的接缝
+class Seam_registry {
+public:
+    // 每个登记项的大致内存：点、到期分块、哈希表节点与到期列表的摊销
+    static const std::size_t bytes_per_entry = 64;
+
+    explicit Seam_registry(double snap) : snap_(snap), inv_(1.0 / snap) {}
+
+    // 距离不超过吸附距离的最近已登记顶点，没有时返回 nullptr
+    const Point3f* find(const Point3f& p) const {
+        const std::int64_t c[3] = {cell(p[0]), cell(p[1]), cell(p[2])};
+        const Point3f* best = nullptr;
+        double best_d2 = snap_ * snap_;
+        for (int dx = -1; dx <= 1; ++dx)
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dz = -1; dz <= 1; ++dz) {
+                    auto it = cells_.find(key(c[0] + dx, c[1] + dy, c[2] + dz));
+                    if (it == cells_.end()) {
+                        continue;
+                    }
+                    for (const Entry& q : it->second) {
+                        double d2 = 0;
+                        for (int i = 0; i < 3; ++i) {
+                            double d = double(p[i]) - q.p[i];
+                            d2 += d * d;
+                        }
+                        if (d2 <= best_d2) {
+                            best_d2 = d2;
+                            best = &q.p;
+                        }
+                    }
+                }
+        return best;
+    }
+
+    // 登记新顶点，expires 为最后一个可能吸附到它的分块
+    void add(const Point3f& p, std::size_t expires) {
+        const std::uint64_t k = key(cell(p[0]), cell(p[1]), cell(p[2]));
+        cells_[k].push_back(Entry{p, expires});
+        if (expiring_.size() <= expires) {
+            expiring_.resize(expires + 1);
+        }
+        expiring_[expires].push_back(k);
+        ++size_;
+        ++registered_;
+    }
+
+    // 分块 c 已输出：删除到期的顶点
+    void evict(std::size_t c) {
+        if (c >= expiring_.size()) {
+            return;
+        }
+        for (std::uint64_t k : expiring_[c]) {
+            auto it = cells_.find(k);
+            if (it == cells_.end()) {
+                continue;
+            }
+            std::vector<Entry>& entries = it->second;
+            const std::size_t before = entries.size();
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [c](const Entry& e) { return e.expires <= c; }),
+                          entries.end());
+            size_ -= before - entries.size();
+            if (entries.empty()) {
+                cells_.erase(it);
+            }
+        }
+        std::vector<std::uint64_t>().swap(expiring_[c]);
+    }
+
+    // 当前占用的内存（字节），计入分块的内存预算
+    std::size_t memory() const { return size_ * bytes_per_entry; }
+    // 累计登记的接缝顶点数
+    std::size_t size() const { return registered_; }
+
+private:
+    struct Entry {
+        Point3f p;
+        std::size_t expires;
+    };
+
+    std::int64_t cell(float x) const { return static_cast<std::int64_t>(std::floor(x * inv_)); }
+    static std::uint64_t key(std::int64_t x, std::int64_t y, std::int64_t z) {
+        // 每轴 21 位，足以覆盖分块接缝附近的格子
+        const std::uint64_t mask = (std::uint64_t(1) << 21) - 1;
+        return ((std::uint64_t(x) & mask) << 42) | ((std::uint64_t(y) & mask) << 21) | (std::uint64_t(z) & mask);
+    }
+
+    double snap_;
+    double inv_;
+    std::unordered_map<std::uint64_t, std::vector<Entry>> cells_;
+    std::vector<std::vector<std::uint64_t>> expiring_;
+    std::size_t size_ = 0;
+    std::size_t registered_ = 0;
+};
+
+class Stream_repairer {
+public:
+    Stream_repairer(const Binary_STL_view& view, const Repair_options& repair_options, const Streaming_options& options)
+        : view_(view), repair_options_(repair_options), options_(options), verbose_(repair_options.verbose) {
+        // 分块修复不逐块打印状态，只在结束时汇总
+        repair_options_.verbose = false;
+        // 壳体被切成多块后各块只能按各自根面片的朝向传播，块间可能相反，在接缝处出错，因此分块时不定向
+        repair_options_.orient_facets = false;
+        // 块的切口本身就是边界环，不能当作洞填补；自相交修复删除相交区域后也会补洞，切口同样会被封上
+        repair_options_.fill_holes = false;
+        repair_options_.repair_self_intersections = false;
+        // 分块只输出归属本块的面，输出顺序由遍历决定，重排顶点没有收益
+        repair_options_.reorder_for_locality = false;
+    }
+
+    // 失败时删除未写完的输出文件
+    bool run(const std::string& output) {
+        if (!scan()) {
+            return false;
+        }
+        if (leaves_.empty()) {
+            std::cerr << "错误：输入中没有面片" << std::endl;
+            return false;
+        }
+
+        STL_append_writer writer;
+        if (!writer.open(output)) {
+            std::cerr << "错误：无法写入文件 " << output << std::endl;
+            if (writer.is_open()) {
+                writer.close();
+                std::remove(output.c_str());
+            }
+            return false;
+        }
+        Seam_registry seams(snap_size());
+        const bool emitted = emit(seams, writer);
+        const std::uint32_t written = writer.count();
+        const bool closed = writer.close();
+        if (!emitted || !closed) {
+            // 临时文件的错误已在 emit 中报告，这里只报告输出文件的写入失败
+            if (!closed) {
+                std::cerr << "错误：写入文件 " << output << " 失败" << std::endl;
+            }
+            std::remove(output.c_str());
+            return false;
+        }
+        if (verbose_) {
+            std::cout << "流式修复完成：" << leaves_.size() << " 个分块，输出 " << written << " 个面片，接缝顶点 "
+                      << seams.size() << " 个" << std::endl;
+        }
+        return true;
+    }
+
+private:
+    // 第一遍扫描：包围盒与面片重心直方图，据此按内存预算切分
+    // 单个直方图格子内的面片就超出预算时无法再切分，报错返回 false
+    bool scan() {
+        const std::size_t nf = view_.number_of_facets();
+        const unsigned chunks = parallel_chunk_count(nf, repair_options_.num_threads);
+        std::vector<std::array<double, 6>> boxes(chunks, std::array<double, 6>{{1e300, 1e300, 1e300, -1e300, -1e300, -1e300}});
+        std::vector<double> extents(chunks, 0.0);
+        parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+            for (std::size_t f = b; f < e; ++f) {
+                float p[3][3];
+                facet_points(view_, f, p);
+                for (int j = 0; j < 3; ++j)
+                    for (int i = 0; i < 3; ++i) {
+                        boxes[t][i] = std::min<double>(boxes[t][i], p[j][i]);
+                        boxes[t][i + 3] = std::max<double>(boxes[t][i + 3], p[j][i]);
+                    }
+                for (int i = 0; i < 3; ++i) {
+                    extents[t] = std::max<double>(extents[t], std::max(p[0][i], std::max(p[1][i], p[2][i])) -
+                                                                  std::min(p[0][i], std::min(p[1][i], p[2][i])));
+                }
+            }
+        }, repair_options_.num_threads);
+        double lo[3] = {1e300, 1e300, 1e300}, hi[3] = {-1e300, -1e300, -1e300};
+        for (const auto& b : boxes)
+            for (int i = 0; i < 3; ++i) {
+                lo[i] = std::min(lo[i], b[i]);
+                hi[i] = std::max(hi[i], b[i + 3]);
+            }
+        if (nf == 0) {
+            return true;
+        }
+        grid_.init(lo, hi);
+        diagonal_ = std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                              (hi[2] - lo[2]) * (hi[2] - lo[2]));
+        overlap_ = options_.overlap > 0 ? options_.overlap : std::min(grid_.size(0), std::min(grid_.size(1), grid_.size(2)));
+        // 输出面的顶点与其重心在每个轴上相距不超过面片的最大跨度，接缝顶点只可能被这一范围内的分块吸附
+        reach_ = *std::max_element(extents.begin(), extents.end()) + overlap_ + snap_size();
+
+        const std::size_t cells = std::size_t(bins) * bins * bins;
+        std::vector<std::vector<std::uint64_t>> local(chunks);
+        parallel_for(nf, [&](std::size_t b, std::size_t e, unsigned t) {
+            local[t].assign(cells, 0);
+            for (std::size_t f = b; f < e; ++f) {
+                ++local[t][centroid_bin(f)];
+            }
+        }, repair_options_.num_threads);
+        std::vector<std::uint64_t> hist(cells, 0);
+        for (const auto& h : local)
+            for (std::size_t i = 0; i < h.size(); ++i)
+                hist[i] += h[i];
+
+        // 预留四分之一预算给重叠区
+        const std::uint64_t max_facets = std::max<std::uint64_t>(1, options_.memory_budget / bytes_per_facet * 3 / 4);
+        Bin_range all = {{0, 0, 0}, {bins, bins, bins}};
+        split(hist, grid_, all, max_facets, leaves_);
+        for (const Bin_range& r : leaves_) {
+            const std::uint64_t n = count_in(hist, r);
+            if (n > max_facets) {
+                std::cerr << "错误：单个直方图格子内有 " << n << " 个面片，无法再切分，超出内存预算；--memory-budget 至少需要 "
+                          << (n * bytes_per_facet * 4 / 3 >> 20) + 1 << " MB" << std::endl;
+                return false;
+            }
+        }
+
+        owner_.assign(cells, -1);
+        for (std::size_t c = 0; c < leaves_.size(); ++c) {
+            const Bin_range& r = leaves_[c];
+            for (int x = r.lo[0]; x < r.hi[0]; ++x)
+                for (int y = r.lo[1]; y < r.hi[1]; ++y)
+                    for (int z = r.lo[2]; z < r.hi[2]; ++z)
+                        owner_[Grid::flat(x, y, z)] = static_cast<int>(c);
+        }
+        return true;
+    }
+
+    // 按组溢写并逐块修复、写出；读写临时文件或写出失败时返回 false
+    bool emit(Seam_registry& seams, STL_append_writer& writer) {
+        for (std::size_t group = 0; group < leaves_.size(); group += max_open_spills) {
+            const std::size_t end = std::min(leaves_.size(), group + max_open_spills);
+            std::vector<std::FILE*> spills;
+            std::vector<std::uint32_t> spill_counts(end - group, 0);
+            bool ok = distribute(group, end, spills, spill_counts);
+            if (!ok) {
+                std::cerr << "错误：无法创建或写入分块临时文件" << std::endl;
+            }
+            for (std::size_t c = group; c < end && ok; ++c) {
+                ok = repair_chunk(c, spills[c - group], spill_counts[c - group], seams, writer);
+                seams.evict(c);
+            }
+            for (std::FILE* s : spills) {
+                std::fclose(s);
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t centroid_bin(std::size_t f) const {
+        float p[3][3];
+        facet_points(view_, f, p);
+        int b[3];
+        for (int i = 0; i < 3; ++i) {
+            b[i] = grid_.bin(i, (double(p[0][i]) + p[1][i] + p[2][i]) / 3.0);
+        }
+        return Grid::flat(b[0], b[1], b[2]);
+    }
+
+    double snap_size() const { return std::max(repair_options_.weld_tolerance, 1e-6 * diagonal_); }
+
+    // 第二遍扫描：按文件顺序把每块（含重叠区）的面片溢写到临时文件，保证分块内顺序确定
+    bool distribute(std::size_t group, std::size_t end, std::vector<std::FILE*>& spills,
+                    std::vector<std::uint32_t>& counts) {
+        for (std::size_t c = group; c < end; ++c) {
+            std::FILE* s = std::tmpfile();
+            if (s == nullptr) {
+                return false;
+            }
+            std::setvbuf(s, nullptr, _IOFBF, 1 << 20);
+            spills.push_back(s);
+        }
+
+        std::vector<int> targets;
+        char record[spill_record_size];
+        for (std::size_t f = 0; f < view_.number_of_facets(); ++f) {
+            float p[3][3];
+            facet_points(view_, f, p);
+            int lo[3], hi[3];
+            for (int i = 0; i < 3; ++i) {
+                double mn = std::min(p[0][i], std::min(p[1][i], p[2][i])) - overlap_;
+                double mx = std::max(p[0][i], std::max(p[1][i], p[2][i])) + overlap_;
+                lo[i] = grid_.bin(i, mn);
+                hi[i] = grid_.bin(i, mx);
+            }
+            targets.clear();
+            for (int x = lo[0]; x <= hi[0]; ++x)
+                for (int y = lo[1]; y <= hi[1]; ++y)
+                    for (int z = lo[2]; z <= hi[2]; ++z) {
+                        int c = owner_[Grid::flat(x, y, z)];
+                        if (c >= static_cast<int>(group) && c < static_cast<int>(end) &&
+                            std::find(targets.begin(), targets.end(), c) == targets.end()) {
+                            targets.push_back(c);
+                        }
+                    }
+            if (targets.empty()) {
+                continue;
+            }
+            const std::uint32_t id = static_cast<std::uint32_t>(f);
+            std::memcpy(record, &id, 4);
+            std::memcpy(record + 4, view_.facet(f) + 12, 36);
+            for (int c : targets) {
+                if (std::fwrite(record, 1, sizeof(record), spills[c - group]) != sizeof(record)) {
+                    return false;
+                }
+                ++counts[c - group];
+            }
+        }
+        return true;
+    }
+
+    // 某顶点是否靠近分块的内部边界（整体包围盒的外侧不算接缝）
+    bool near_seam(const Bin_range& r, const Point3f& p) const {
+        for (int i = 0; i < 3; ++i) {
+            if (r.lo[i] > 0 && p[i] < grid_.coord(i, r.lo[i]) + overlap_) {
+                return true;
+            }
+            if (r.hi[i] < bins && p[i] > grid_.coord(i, r.hi[i]) - overlap_) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 最后一个可能吸附到 p 的分块：重心格子与 p 在每个轴上相距不超过 reach_ 的分块中编号最大者
+    // 范围内格子不多时逐格查找，否则逐块检查分块的格子区间
+    std::size_t last_reader(const Point3f& p, std::size_t c) const {
+        int lo[3], hi[3];
+        std::size_t volume = 1;
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = grid_.bin(i, p[i] - reach_);
+            hi[i] = grid_.bin(i, p[i] + reach_);
+            volume *= static_cast<std::size_t>(hi[i] - lo[i] + 1);
+        }
+        std::size_t last = c;
+        if (volume <= leaves_.size()) {
+            for (int x = lo[0]; x <= hi[0]; ++x)
+                for (int y = lo[1]; y <= hi[1]; ++y)
+                    for (int z = lo[2]; z <= hi[2]; ++z) {
+                        const int o = owner_[Grid::flat(x, y, z)];
+                        if (o >= 0) {
+                            last = std::max(last, static_cast<std::size_t>(o));
+                        }
+                    }
+            return last;
+        }
+        for (std::size_t l = leaves_.size(); l-- > last;) {
+            const Bin_range& r = leaves_[l];
+            if (r.lo[0] <= hi[0] && r.hi[0] > lo[0] && r.lo[1] <= hi[1] && r.hi[1] > lo[1] && r.lo[2] <= hi[2] &&
+                r.hi[2] > lo[2]) {
+                return l;
+            }
+        }
+        return last;
+    }
+
+    // 读回溢写记录不足 n 条或写出失败时返回 false
+    bool repair_chunk(std::size_t c, std::FILE* spill, std::uint32_t n, Seam_registry& seams,
+                      STL_append_writer& writer) {
+        if (n == 0) {
+            return true;
+        }
+        // 切分只按重心计数，重叠区的面片与接缝登记表可能使分块超出预算
+        const std::uint64_t needed = std::uint64_t(n) * bytes_per_facet + seams.memory();
+        if (needed > options_.memory_budget) {
+            std::cerr << "错误：分块 " << c << " 含重叠区共 " << n << " 个面片，接缝登记表占用 " << (seams.memory() >> 20)
+                      << " MB，超出内存预算；--memory-budget 至少需要 " << (needed >> 20) + 1 << " MB" << std::endl;
+            return false;
+        }
+        // 把溢写记录还原成内存中的二进制 STL，复用焊接与修复流程
+        std::vector<char> buffer(Binary_STL_view::header_size + std::size_t(n) * Binary_STL_view::facet_size, 0);
+        std::memcpy(buffer.data() + 80, &n, 4);
+        std::rewind(spill);
+        char record[spill_record_size];
+        for (std::uint32_t i = 0; i < n; ++i) {
+            if (std::fread(record, 1, sizeof(record), spill) != sizeof(record)) {
+                std::cerr << "错误：读取分块临时文件失败（分块 " << c << "，" << i << " / " << n << " 条记录）"
+                          << std::endl;
+                return false;
+            }
+            std::memcpy(buffer.data() + Binary_STL_view::header_size + i * Binary_STL_view::facet_size + 12,
+                        record + 4, 36);
+        }
+
+        STL_soup soup;
+        {
+            Binary_STL_view chunk_view(buffer.data(), buffer.size());
+            Weld_options weld;
+            weld.tolerance = repair_options_.weld_tolerance;
+            weld.num_threads = repair_options_.num_threads;
+            weld_binary_STL(chunk_view, weld, soup);
+        }
+        std::vector<char>().swap(buffer);
+
+        LAR_STL repaired(std::move(soup), repair_options_);
+        soup = STL_soup();
+        const Surface_mesh& m = repaired.get_repaired_mesh();
+        const Bin_range& r = leaves_[c];
+
+        // 只输出重心落在本块内的面；接缝附近的顶点统一吸附
+        for (auto f : m.faces()) {
+            auto h = m.halfedge(f);
+            const K::Point_3* q[3] = {&m.point(m.source(h)), &m.point(m.target(h)), &m.point(m.target(m.next(h)))};
+            int b[3];
+            for (int i = 0; i < 3; ++i) {
+                b[i] = grid_.bin(i, (q[0]->cartesian(i) + q[1]->cartesian(i) + q[2]->cartesian(i)) / 3.0);
+            }
+            if (owner_[Grid::flat(b[0], b[1], b[2])] != static_cast<int>(c)) {
+                continue;
+            }
+            Point3f p[3];
+            for (int j = 0; j < 3; ++j) {
+                p[j] = {{static_cast<float>(q[j]->x()), static_cast<float>(q[j]->y()), static_cast<float>(q[j]->z())}};
+                if (near_seam(r, p[j])) {
+                    if (const Point3f* q = seams.find(p[j])) {
+                        p[j] = *q;
+                    } else {
+                        seams.add(p[j], last_reader(p[j], c));
+                    }
+                }
+            }
+            if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2]) {
+                continue;
+            }
+            if (!writer.write(p)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const Binary_STL_view& view_;
+    Repair_options repair_options_;
+    Streaming_options options_;
+    bool verbose_;
+    Grid grid_;
+    double diagonal_ = 0;
+    double overlap_ = 0;
+    // 接缝顶点可能被吸附的最大距离
+    double reach_ = 0;
+    std::vector<Bin_range> leaves_;
+    std::vector<int> owner_;
+};
+
+} // namespace
+
+bool stream_repair_STL(const std::string& input, const std::string& output,
+                       const Repair_options& repair_options, const Streaming_options& options) {
+    Mapped_file file(input);
+    if (!file.is_open()) {
+        std::cerr << "错误：无法打开文件 " << input << std::endl;
+        return false;
+    }
+    Binary_STL_view view(file.data(), file.size());
+    if (!view.is_valid()) {
+        std::cerr << "错误：流式修复只支持二进制 STL" << std::endl;
+        return false;
+    }
+    return Stream_repairer(view, repair_options, options).run(output);
+}
@@ -0,0 +1,25 @@
+#ifndef LAR_STREAMING_REPAIR_H
+#define LAR_STREAMING_REPAIR_H
+
+#include "LAR_STL.h"
+
+#include <string>
+
+// 流式修复参数
+struct Streaming_options {
+    // 单个分块修复时允许使用的内存（字节），决定分块大小
+    std::size_t memory_budget = std::size_t(1) << 30;
+    // 分块之间的重叠宽度；0 表示取一个直方图格子的宽度
+    double overlap = 0.0;
+};
+
+// 对超出内存的二进制 STL 做流式修复：
+// 1. 扫描一遍统计包围盒与面片重心直方图，按内存预算做 k-d 切分
+// 2. 再扫描一遍，把每个分块（含重叠区）的面片溢写到临时文件
+// 3. 逐块焊接并修复，只输出重心落在本块内的面，边界附近的顶点吸附到已输出的接缝位置
+// 4. 结果按块增量写出，峰值内存由预算而不是网格大小决定
+// 面片过于密集、单个直方图格子或含重叠区的分块超出预算时报错返回 false，不会越过预算
+bool stream_repair_STL(const std::string& input, const std::string& output,
+                       const Repair_options& repair_options, const Streaming_options& options);
+
+#endif
@@ -0,0 +1,156 @@
+#include "Thread_pool.h"
+#include "Parallel.h"
+
+#include <atomic>
+
+namespace {
+// 当前线程所属的线程池及其编号
+thread_local const Thread_pool* current_pool = nullptr;
+thread_local int current_index = -1;
+} // namespace
+
+Thread_pool::Thread_pool(unsigned num_threads)
+    : queued_(0), pending_(0), stop_(false) {
+    const unsigned n = resolve_thread_count(num_threads);
+    for (unsigned i = 0; i < n; ++i) {
+        queues_.emplace_back(new Queue());
+    }
+    for (unsigned i = 0; i < n; ++i) {
+        workers_.emplace_back(&Thread_pool::worker_loop, this, i);
+    }
+}
+
+Thread_pool::~Thread_pool() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        all_done_.wait(lock, [this]() { return pending_ == 0; });
+        stop_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& w : workers_) {
+        w.join();
+    }
+}
+
+int Thread_pool::current_worker() const {
+    return current_pool == this ? current_index : -1;
+}
+
+void Thread_pool::submit(std::function<void()> task) {
+    int self = current_worker();
+    Queue& target = self >= 0 ? *queues_[self] : injection_;
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        ++queued_;
+        ++pending_;
+    }
+    work_available_.notify_one();
+}
+
+void Thread_pool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    all_done_.wait(lock, [this]() { return pending_ == 0; });
+    if (first_error_) {
+        std::exception_ptr error = first_error_;
+        first_error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void Thread_pool::run_all(std::size_t n, const std::function<void(std::size_t)>& task) {
+    if (n == 0) {
+        return;
+    }
+    std::atomic<std::size_t> remaining(n - 1);
+    for (std::size_t i = 1; i < n; ++i) {
+        submit([&task, &remaining, i]() {
+            task(i);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    task(0);
+    const int self = current_worker();
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::function<void()> other;
+        if (self >= 0 && pop_or_steal(self, other, false)) {
+            execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool Thread_pool::pop_or_steal(int index, std::function<void()>& task, bool take_injected) {
+    if (index >= 0) {
+        Queue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    if (take_injected) {
+        std::lock_guard<std::mutex> lock(injection_.mutex);
+        if (!injection_.tasks.empty()) {
+            task = std::move(injection_.tasks.front());
+            injection_.tasks.pop_front();
+            return true;
+        }
+    }
+    for (unsigned k = 1; k <= size(); ++k) {
+        const unsigned victim_index = (static_cast<unsigned>(index < 0 ? 0 : index) + k) % size();
+        if (static_cast<int>(victim_index) == index) {
+            continue;
+        }
+        Queue& victim = *queues_[victim_index];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Thread_pool::execute(std::function<void()>& task) {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        --queued_;
+    }
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (!first_error_) {
+            first_error_ = std::current_exception();
+        }
+    }
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (--pending_ == 0) {
+        all_done_.notify_all();
+    }
+}
+
+void Thread_pool::worker_loop(unsigned index) {
+    current_pool = this;
+    current_index = static_cast<int>(index);
+    for (;;) {
+        std::function<void()> task;
+        if (pop_or_steal(static_cast<int>(index), task, true)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        work_available_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+        if (stop_ && queued_ == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef LAR_THREAD_POOL_H
+#define LAR_THREAD_POOL_H
+
+#include "Parallel.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池
+// 每个工作线程有自己的双端队列：自己从尾部取（后进先出，缓存友好），
+// 空闲时先从共享的注入队列头部取外部提交的任务（先进先出，保持提交顺序），再从其他线程的队列头部窃取
+// 也可作为 parallel_for 的常驻执行器：各块放入调用线程的队列，调用者等待期间帮忙执行本池中的块
+class Thread_pool : public Parallel_executor {
+public:
+    // num_threads 为 0 时使用全部硬件线程
+    explicit Thread_pool(unsigned num_threads = 0);
+    // 等待已提交的任务全部完成后再退出
+    ~Thread_pool();
+
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    // 提交任务：在工作线程中提交时放入本线程队列，否则放入注入队列，按提交顺序被领取
+    void submit(std::function<void()> task);
+    // 阻塞直到所有已提交任务执行完毕；若有任务抛出异常，重新抛出第一个
+    void wait();
+
+    // Parallel_executor：task(0) 在调用线程执行，其余放入队列；等待期间只执行各工作线程队列中的任务，
+    // 不领取注入队列中外部提交的大任务，因此不会在一个任务的等待中嵌套执行另一个任务
+    void run_all(std::size_t n, const std::function<void(std::size_t)>& task) override;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+    // 当前线程在本池中的编号，不是本池的工作线程时返回 -1
+    int current_worker() const;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void worker_loop(unsigned index);
+    // index 为 -1 时只窃取；take_injected 为假时不领取注入队列
+    bool pop_or_steal(int index, std::function<void()>& task, bool take_injected);
+    void execute(std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    Queue injection_;
+    std::vector<std::thread> workers_;
+
+    std::mutex state_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    std::size_t queued_;
+    std::size_t pending_;
+    bool stop_;
+    std::exception_ptr first_error_;
+};
+
+#endif
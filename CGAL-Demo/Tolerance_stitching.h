@@ -0,0 +1,136 @@
+#ifndef LAR_TOLERANCE_STITCHING_H
+#define LAR_TOLERANCE_STITCHING_H
+
+#include "Parallel.h"
+
+#include <CGAL/Fuzzy_sphere.h>
+#include <CGAL/Kd_tree.h>
+#include <CGAL/Kernel_traits.h>
+#include <CGAL/Search_traits_3.h>
+#include <CGAL/Search_traits_adapter.h>
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/Polygon_mesh_processing/connected_components.h>
+#include <CGAL/Polygon_mesh_processing/stitch_borders.h>
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 容差缝合结果
+struct Tolerance_stitching_report {
+    std::size_t components = 0;
+    std::size_t border_halfedges = 0;
+    std::size_t matched_pairs = 0;
+    std::size_t stitched_pairs = 0;
+};
+
+// 按连通分量并行的容差缝合：
+// 每个分量对自己的边界顶点建 k-d 树，对每条边界半边 (s, t) 在 s 的容差球内找候选顶点，
+// 再检查以候选顶点为终点的边界半边，其起点是否也在 t 的容差内；
+// 分量内按距离之和贪心配对，最后按分量顺序串行调用 stitch_borders，结果与线程数无关
+template <typename Point>
+Tolerance_stitching_report stitch_borders_with_tolerance(CGAL::Surface_mesh<Point>& mesh, double tolerance,
+                                                         unsigned num_threads = 0) {
+    typedef CGAL::Surface_mesh<Point> Mesh;
+    typedef typename CGAL::Kernel_traits<Point>::Kernel Kernel;
+    typedef typename Mesh::Vertex_index Vertex_index;
+    typedef typename Mesh::Halfedge_index Halfedge_index;
+    typedef typename Mesh::Face_index Face_index;
+    typedef typename Mesh::template Property_map<Vertex_index, Point> VPM;
+    typedef CGAL::Search_traits_3<Kernel> Traits_base;
+    typedef CGAL::Search_traits_adapter<Vertex_index, VPM, Traits_base> Traits;
+    typedef CGAL::Kd_tree<Traits> Tree;
+    typedef CGAL::Fuzzy_sphere<Traits> Sphere;
+    typedef std::pair<Halfedge_index, Halfedge_index> Halfedge_pair;
+
+    Tolerance_stitching_report report;
+    auto fcc = mesh.template add_property_map<Face_index, std::size_t>("f:lar_stitch_cc", 0).first;
+    report.components = CGAL::Polygon_mesh_processing::connected_components(mesh, fcc);
+
+    // 按所属分量收集边界半边
+    std::vector<std::vector<Halfedge_index>> borders(report.components);
+    for (Halfedge_index h : mesh.halfedges()) {
+        // 两侧都是边界的悬空边不属于任何分量，跳过
+        if (mesh.is_border(h) && !mesh.is_border(mesh.opposite(h))) {
+            borders[fcc[mesh.face(mesh.opposite(h))]].push_back(h);
+            ++report.border_halfedges;
+        }
+    }
+    mesh.remove_property_map(fcc);
+
+    const VPM vpm = mesh.points();
+    const double tol2 = tolerance * tolerance;
+    std::vector<std::vector<Halfedge_pair>> matches(report.components);
+
+    parallel_for_dynamic(report.components, [&](std::size_t c, unsigned) {
+        const std::vector<Halfedge_index>& hs = borders[c];
+        if (hs.size() < 2) {
+            return;
+        }
+        // 以终点索引边界半边，并对边界顶点建 k-d 树
+        std::unordered_map<Vertex_index, std::vector<Halfedge_index>> by_target;
+        std::vector<Vertex_index> verts;
+        for (Halfedge_index h : hs) {
+            auto& list = by_target[mesh.target(h)];
+            if (list.empty()) {
+                verts.push_back(mesh.target(h));
+            }
+            list.push_back(h);
+        }
+        Tree tree(verts.begin(), verts.end(), typename Tree::Splitter(), Traits(vpm));
+
+        struct Candidate {
+            double score;
+            Halfedge_index a, b;
+            bool operator<(const Candidate& o) const {
+                return score != o.score ? score < o.score : (a != o.a ? a < o.a : b < o.b);
+            }
+        };
+        std::vector<Candidate> candidates;
+        std::vector<Vertex_index> near;
+        for (Halfedge_index h : hs) {
+            near.clear();
+            tree.search(std::back_inserter(near), Sphere(mesh.source(h), tolerance, 0, Traits(vpm)));
+            const Point& t = mesh.point(mesh.target(h));
+            for (Vertex_index v : near) {
+                for (Halfedge_index g : by_target[v]) {
+                    // 每对只从编号较小的一侧记录，并排除相邻的半边
+                    if (!(h < g) || mesh.next(h) == g || mesh.next(g) == h) {
+                        continue;
+                    }
+                    const double d_end = CGAL::to_double(CGAL::squared_distance(t, mesh.point(mesh.source(g))));
+                    if (d_end > tol2) {
+                        continue;
+                    }
+                    const double d_start =
+                        CGAL::to_double(CGAL::squared_distance(mesh.point(mesh.source(h)), mesh.point(v)));
+                    candidates.push_back({d_start + d_end, h, g});
+                }
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        std::unordered_map<Halfedge_index, bool> used;
+        for (const Candidate& cand : candidates) {
+            if (used[cand.a] || used[cand.b]) {
+                continue;
+            }
+            used[cand.a] = used[cand.b] = true;
+            matches[c].push_back(Halfedge_pair(cand.a, cand.b));
+        }
+    }, num_threads);
+
+    std::vector<Halfedge_pair> pairs;
+    for (const auto& m : matches) {
+        pairs.insert(pairs.end(), m.begin(), m.end());
+    }
+    report.matched_pairs = pairs.size();
+    if (!pairs.empty()) {
+        report.stitched_pairs = CGAL::Polygon_mesh_processing::stitch_borders(mesh, pairs);
+    }
+    return report;
+}
+
+#endif
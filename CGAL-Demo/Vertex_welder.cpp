@@ -0,0 +1,277 @@
+#include "Vertex_welder.h"
+#include "Parallel.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// 量化后的格子坐标；容差为 0 时直接存放坐标的位模式
+struct Cell {
+    std::int64_t x, y, z;
+    bool operator==(const Cell& o) const { return x == o.x && y == o.y && z == o.z; }
+};
+
+struct Cell_hash {
+    std::size_t operator()(const Cell& c) const {
+        std::uint64_t h = static_cast<std::uint64_t>(c.x) * 0x9E3779B97F4A7C15ull;
+        h ^= (static_cast<std::uint64_t>(c.y) + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+        h ^= (static_cast<std::uint64_t>(c.z) + 0x165667B19E3779F9ull) * 0x27D4EB2F165667C5ull;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+};
+
+// 每个格子记录编号最小的角点与格内角点链表的表头（链表经 next_ 串起格内所有角点）
+struct Cell_entry {
+    std::uint32_t first;
+    std::uint32_t head;
+};
+
+typedef std::unordered_map<Cell, Cell_entry, Cell_hash> Cell_map;
+
+const std::uint32_t no_corner = std::numeric_limits<std::uint32_t>::max();
+
+class Welder {
+public:
+    // 角点来自二进制 STL 视图（view 非空）或连续的 float 数组（每面片 9 个）
+    Welder(const Binary_STL_view* view, const float* corners, std::size_t nb_facets, const Weld_options& options)
+        : view_(view),
+          corners_(corners),
+          nb_facets_(nb_facets),
+          threads_(options.num_threads),
+          // 格子边长取 tolerance，容差内的两点在每个轴上至多相隔一格，必定落在彼此的 27 邻域内
+          inv_cell_(options.tolerance > 0 ? 1.0 / options.tolerance : 0.0),
+          tol2_(options.tolerance * options.tolerance) {}
+
+    void run(STL_soup& soup) {
+        const std::size_t nc = 3 * nb_facets_;
+        soup.points.clear();
+        soup.triangles.clear();
+        if (nc == 0) {
+            return;
+        }
+        if (nc > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("STL 面片过多，超出 32 位顶点索引范围");
+        }
+
+        const unsigned chunks = parallel_chunk_count(nc, threads_);
+        const std::size_t nb_shards = 4 * static_cast<std::size_t>(chunks);
+        build_shards(nc, chunks, nb_shards);
+
+        // 容差内的点对并入同一集合，合并时总把较大的根挂到较小的根下，最终的根即集合中编号最小的角点
+        parent_.reset(new std::atomic<std::uint32_t>[nc]);
+        parallel_for(nc, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t c = b; c < e; ++c) {
+                parent_[c].store(static_cast<std::uint32_t>(c), std::memory_order_relaxed);
+            }
+        }, threads_);
+        parallel_for(nc, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t c = b; c < e; ++c) {
+                link_neighbours(static_cast<std::uint32_t>(c));
+            }
+        }, threads_);
+
+        std::vector<std::uint32_t> root(nc);
+        parallel_for(nc, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t c = b; c < e; ++c) {
+                root[c] = find(static_cast<std::uint32_t>(c));
+            }
+        }, threads_);
+        parent_.reset();
+
+        // 根按角点编号顺序压缩成连续的顶点编号（分块前缀和）
+        std::vector<std::size_t> counts(chunks + 1, 0);
+        parallel_for(nc, [&](std::size_t b, std::size_t e, unsigned t) {
+            std::size_t n = 0;
+            for (std::size_t c = b; c < e; ++c) {
+                n += (root[c] == c);
+            }
+            counts[t + 1] = n;
+        }, threads_);
+        for (unsigned t = 0; t < chunks; ++t) {
+            counts[t + 1] += counts[t];
+        }
+
+        std::vector<std::uint32_t> index(nc);
+        soup.points.resize(counts[chunks]);
+        parallel_for(nc, [&](std::size_t b, std::size_t e, unsigned t) {
+            std::size_t next = counts[t];
+            for (std::size_t c = b; c < e; ++c) {
+                if (root[c] == c) {
+                    float p[3];
+                    position(static_cast<std::uint32_t>(c), p);
+                    soup.points[next] = {{p[0], p[1], p[2]}};
+                    index[c] = static_cast<std::uint32_t>(next++);
+                }
+            }
+        }, threads_);
+
+        soup.triangles.resize(nb_facets_);
+        parallel_for(soup.triangles.size(), [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t f = b; f < e; ++f) {
+                for (int j = 0; j < 3; ++j) {
+                    soup.triangles[f][j] = index[root[3 * f + j]];
+                }
+            }
+        }, threads_);
+    }
+
+private:
+    void position(std::uint32_t c, float p[3]) const {
+        if (view_ != nullptr) {
+            view_->vertex(c / 3, static_cast<int>(c % 3), p);
+        } else {
+            std::memcpy(p, corners_ + 3 * static_cast<std::size_t>(c), 3 * sizeof(float));
+        }
+    }
+
+    Cell cell_of(const float p[3]) const {
+        Cell cell;
+        std::int64_t* out[3] = {&cell.x, &cell.y, &cell.z};
+        for (int i = 0; i < 3; ++i) {
+            if (inv_cell_ > 0) {
+                *out[i] = static_cast<std::int64_t>(std::floor(static_cast<double>(p[i]) * inv_cell_));
+            } else {
+                float v = (p[i] == 0.0f) ? 0.0f : p[i]; // -0.0 与 0.0 视为同一点
+                std::uint32_t bits;
+                std::memcpy(&bits, &v, sizeof(bits));
+                *out[i] = bits;
+            }
+        }
+        return cell;
+    }
+
+    std::size_t shard_of(const Cell& cell) const { return Cell_hash()(cell) % shards_.size(); }
+
+    // 按线程划分角点并按格子分片，再让每个分片由单个线程建表
+    // 每个分片按线程序号、角点序号依次插入，先插入者即格内编号最小的角点；各分片只写自己角点的 next_
+    void build_shards(std::size_t nc, unsigned chunks, std::size_t nb_shards) {
+        shards_.assign(nb_shards, Cell_map());
+        next_.assign(nc, no_corner);
+        std::vector<std::vector<std::vector<std::uint32_t>>> buckets(chunks, std::vector<std::vector<std::uint32_t>>(nb_shards));
+        parallel_for(nc, [&](std::size_t b, std::size_t e, unsigned t) {
+            for (std::size_t c = b; c < e; ++c) {
+                float p[3];
+                position(static_cast<std::uint32_t>(c), p);
+                buckets[t][shard_of(cell_of(p))].push_back(static_cast<std::uint32_t>(c));
+            }
+        }, threads_);
+
+        parallel_for(nb_shards, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t s = b; s < e; ++s) {
+                std::size_t total = 0;
+                for (unsigned t = 0; t < chunks; ++t) {
+                    total += buckets[t][s].size();
+                }
+                shards_[s].reserve(total / 3 + 1);
+                for (unsigned t = 0; t < chunks; ++t) {
+                    for (std::uint32_t c : buckets[t][s]) {
+                        float p[3];
+                        position(c, p);
+                        auto inserted = shards_[s].emplace(cell_of(p), Cell_entry{c, c});
+                        if (!inserted.second) {
+                            next_[c] = inserted.first->second.head;
+                            inserted.first->second.head = c;
+                        }
+                    }
+                    std::vector<std::uint32_t>().swap(buckets[t][s]);
+                }
+            }
+        }, threads_, 1);
+    }
+
+    std::uint32_t find(std::uint32_t x) const {
+        std::uint32_t p = parent_[x].load(std::memory_order_relaxed);
+        while (p != x) {
+            x = p;
+            p = parent_[x].load(std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    void unite(std::uint32_t a, std::uint32_t b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            // a 仍是根时才挂到 b 下，否则已被其他线程合并，重新查找
+            std::uint32_t expected = a;
+            if (parent_[a].compare_exchange_weak(expected, b, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // 与本格及 26 个相邻格子中所有容差内、编号更小的角点合并；容差为 0 时只与本格编号最小的角点合并
+    void link_neighbours(std::uint32_t c) {
+        float p[3];
+        position(c, p);
+        const Cell home = cell_of(p);
+        if (inv_cell_ <= 0) {
+            const std::uint32_t first = shards_[shard_of(home)].find(home)->second.first;
+            if (first != c) {
+                unite(c, first);
+            }
+            return;
+        }
+
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dz = -1; dz <= 1; ++dz) {
+                    const Cell cell = {home.x + dx, home.y + dy, home.z + dz};
+                    const Cell_map& shard = shards_[shard_of(cell)];
+                    auto it = shard.find(cell);
+                    if (it == shard.end() || it->second.first >= c) {
+                        continue;
+                    }
+                    for (std::uint32_t q = it->second.head; q != no_corner; q = next_[q]) {
+                        if (q >= c) {
+                            continue;
+                        }
+                        float x[3];
+                        position(q, x);
+                        double d2 = 0;
+                        for (int i = 0; i < 3; ++i) {
+                            double d = static_cast<double>(p[i]) - x[i];
+                            d2 += d * d;
+                        }
+                        if (d2 <= tol2_) {
+                            unite(c, q);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    const Binary_STL_view* view_;
+    const float* corners_;
+    std::size_t nb_facets_;
+    unsigned threads_;
+    double inv_cell_;
+    double tol2_;
+    std::vector<Cell_map> shards_;
+    std::vector<std::uint32_t> next_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> parent_;
+};
+
+} // namespace
+
+void weld_binary_STL(const Binary_STL_view& view, const Weld_options& options, STL_soup& soup) {
+    Welder(&view, nullptr, view.number_of_facets(), options).run(soup);
+}
+
+void weld_STL_corners(const std::vector<float>& corners, const Weld_options& options, STL_soup& soup) {
+    Welder(nullptr, corners.data(), corners.size() / 9, options).run(soup);
+}
@@ -0,0 +1,24 @@
+#ifndef LAR_VERTEX_WELDER_H
+#define LAR_VERTEX_WELDER_H
+
+#include "STL_reader.h"
+
+// 顶点焊接参数
+struct Weld_options {
+    // 焊接容差：距离不超过该值的点会被合并；0 表示只合并坐标完全相同的点
+    double tolerance = 0.0;
+    // 线程数，0 表示使用全部硬件线程
+    unsigned num_threads = 0;
+};
+
+// 多线程焊接二进制 STL 的三角形汤
+// 1. 按线程划分角点，并按量化坐标所在格子的哈希分片
+// 2. 每个分片由一个线程独占建表，无需加锁，格子边长等于容差，表中记下格内的全部角点
+// 3. 并行检查每个角点与相邻 27 个格子中所有角点的距离，容差内的点对用无锁并查集合并
+// 焊接结果是“距离不超过容差”关系的连通分量，每个分量取编号最小的角点，与线程数无关
+void weld_binary_STL(const Binary_STL_view& view, const Weld_options& options, STL_soup& soup);
+
+// 同上，角点来自连续的 float 数组（每个面片 9 个，如 ASCII STL 的解析结果）
+void weld_STL_corners(const std::vector<float>& corners, const Weld_options& options, STL_soup& soup);
+
+#endif
@@ -0,0 +1,196 @@
+// 修复流程与 PMP 示例算子的规模基准
+// 用法: bench_pipeline [--sizes 10000,100000,...] [--pmp-limit <面片数>] [--threads <数量>] [--keep]
+// 对每个规模先用 generate_damaged_STL 生成带缺陷的模型，再计时 LAR_STL 的每个阶段，
+// 面片数不超过 pmp-limit 时继续计时示例程序中用到的 PMP 算子；结果以 CSV 输出到标准输出
+#include "../LAR_STL.h"
+#include "../Damaged_mesh_generator.h"
+#include "../Stage_profiler.h"
+
+#include <CGAL/Mesh_constant_domain_field_3.h>
+#include <CGAL/Polygon_mesh_processing/angle_and_area_smoothing.h>
+#include <CGAL/Polygon_mesh_processing/detect_features.h>
+#include <CGAL/Polygon_mesh_processing/fair.h>
+#include <CGAL/Polygon_mesh_processing/refine.h>
+#include <CGAL/Polygon_mesh_processing/smooth_shape.h>
+#include <CGAL/Polygon_mesh_processing/surface_Delaunay_remeshing.h>
+#include <CGAL/Polygon_mesh_processing/triangulate_faces.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// 缺陷数量随规模线性增长，保证各规模下修复工作量的比例一致
+Defect_options defects_for(std::size_t facets) {
+    Defect_options options;
+    options.facets = facets;
+    options.gaps = std::max<std::size_t>(1, facets / 20000);
+    options.duplicate_ratio = 0.001;
+    options.non_manifold_vertices = std::max<std::size_t>(1, facets / 20000);
+    options.isolated_vertices = std::max<std::size_t>(1, facets / 20000);
+    options.flipped_ratio = 0.001;
+    return options;
+}
+
+void print_rows(std::size_t facets, const Stage_profiler& profiler) {
+    for (const Stage_record& s : profiler.stages()) {
+        std::cout << facets << "," << s.name << "," << s.wall_seconds << "," << s.cpu_seconds << ","
+                  << s.peak_rss_delta << "," << s.vertices << "," << s.faces << std::endl;
+    }
+}
+
+// 从种子顶点出发的 k 环邻域，作为光顺（fair）区域
+std::vector<Surface_mesh::Vertex_index> k_ring(const Surface_mesh& mesh, Surface_mesh::Vertex_index seed, int k) {
+    std::vector<Surface_mesh::Vertex_index> ring(1, seed);
+    std::unordered_set<Surface_mesh::Vertex_index> seen(ring.begin(), ring.end());
+    std::size_t begin = 0;
+    for (int level = 0; level < k; ++level) {
+        const std::size_t end = ring.size();
+        for (std::size_t i = begin; i < end; ++i) {
+            for (auto v : CGAL::vertices_around_target(mesh.halfedge(ring[i]), mesh)) {
+                if (seen.insert(v).second) {
+                    ring.push_back(v);
+                }
+            }
+        }
+        begin = end;
+    }
+    return ring;
+}
+
+// 依次计时示例程序中的 PMP 算子，每个算子在修复结果的副本上运行
+void run_pmp_operations(const Surface_mesh& repaired, Stage_profiler& profiler) {
+    {
+        Surface_mesh mesh = repaired;
+        profiler.start("pmp_triangulate_faces");
+        PMP::triangulate_faces(mesh);
+        profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+    }
+    {
+        Surface_mesh mesh = repaired;
+        auto eif = get(CGAL::edge_is_feature, mesh);
+        profiler.start("pmp_detect_sharp_edges");
+        PMP::detect_sharp_edges(mesh, 60, eif);
+        profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+
+        profiler.start("pmp_angle_and_area_smoothing");
+        PMP::angle_and_area_smoothing(mesh, CGAL::parameters::number_of_iterations(1)
+                                                .use_safety_constraints(false)
+                                                .edge_is_constrained_map(eif));
+        profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+    }
+    {
+        Surface_mesh mesh = repaired;
+        profiler.start("pmp_smooth_shape");
+        PMP::smooth_shape(mesh, 0.0001, CGAL::parameters::number_of_iterations(1));
+        profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+    }
+    {
+        Surface_mesh mesh = repaired;
+        std::vector<Surface_mesh::Face_index> new_faces;
+        std::vector<Surface_mesh::Vertex_index> new_vertices;
+        profiler.start("pmp_refine");
+        PMP::refine(mesh, faces(mesh), std::back_inserter(new_faces), std::back_inserter(new_vertices),
+                    CGAL::parameters::density_control_factor(2.));
+        profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+
+        if (!mesh.is_empty()) {
+            std::vector<Surface_mesh::Vertex_index> region = k_ring(mesh, *mesh.vertices().begin(), 12);
+            profiler.start("pmp_fair");
+            PMP::fair(mesh, region);
+            profiler.stop(mesh.number_of_vertices(), mesh.number_of_faces());
+        }
+    }
+    {
+        // 目标边长取平均边长，尺寸与输入规模同步缩放
+        double total = 0;
+        for (auto e : repaired.edges()) {
+            total += std::sqrt(CGAL::to_double(CGAL::squared_distance(repaired.point(repaired.vertex(e, 0)),
+                                                                      repaired.point(repaired.vertex(e, 1)))));
+        }
+        const double edge_length = repaired.number_of_edges() > 0 ? total / repaired.number_of_edges() : 1.0;
+        CGAL::Mesh_constant_domain_field_3<K, int> size(edge_length);
+        Surface_mesh mesh = repaired;
+        auto eif = get(CGAL::edge_is_feature, mesh);
+        PMP::detect_sharp_edges(mesh, 45, eif);
+        profiler.start("pmp_surface_Delaunay_remeshing");
+        Surface_mesh out = PMP::surface_Delaunay_remeshing(mesh, CGAL::parameters::protect_constraints(true)
+                                                                     .mesh_edge_size(size)
+                                                                     .mesh_facet_distance(edge_length / 2)
+                                                                     .edge_is_constrained_map(eif));
+        profiler.stop(out.number_of_vertices(), out.number_of_faces());
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::size_t> sizes = {10000, 100000, 1000000, 10000000, 50000000};
+    std::size_t pmp_limit = 1000000;
+    bool keep = false;
+    Repair_options options;
+    options.verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                sizes.push_back(std::strtoull(item.c_str(), nullptr, 10));
+            }
+        } else if (arg == "--pmp-limit" && i + 1 < argc) {
+            pmp_limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.num_threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--keep") {
+            keep = true;
+        } else {
+            std::cerr << "用法: " << argv[0]
+                      << " [--sizes 10000,100000,...] [--pmp-limit <面片数>] [--threads <数量>] [--keep]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "facets,stage,wall_seconds,cpu_seconds,peak_rss_delta,vertices,faces" << std::endl;
+    for (std::size_t facets : sizes) {
+        const std::string input = "bench_pipeline_" + std::to_string(facets) + ".stl";
+        const std::string output = "bench_pipeline_" + std::to_string(facets) + "_repaired.stl";
+
+        Stage_profiler generation;
+        generation.start("generate");
+        const std::size_t written = generate_damaged_STL(input, defects_for(facets));
+        generation.stop(0, written);
+        if (written == 0) {
+            std::cerr << "生成失败: " << input << std::endl;
+            return 1;
+        }
+        print_rows(facets, generation);
+
+        {
+            LAR_STL stl(input, options);
+            stl.save_repaired_mesh(output);
+            print_rows(facets, stl.get_profile());
+
+            if (written <= pmp_limit) {
+                Stage_profiler pmp;
+                run_pmp_operations(stl.get_repaired_mesh(), pmp);
+                print_rows(facets, pmp);
+            }
+        }
+
+        if (!keep) {
+            std::remove(input.c_str());
+            std::remove(output.c_str());
+        }
+    }
+    return 0;
+}
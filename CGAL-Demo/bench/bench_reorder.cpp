@@ -0,0 +1,194 @@
+// 衡量 Morton 重排对网格遍历缓存命中的影响
+// 用法: bench_reorder [输入 STL] [复制份数]
+// 输入模型被平移复制若干份，顶点与面的编号随机打乱（模拟多轮修复后的碎片化顺序），
+// 然后分别在重排前后做一环邻域遍历和逐面遍历，用 perf_event_open 统计缓存未命中次数
+#include "../STL_reader.h"
+#include "../Mesh_reorder.h"
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Surface_mesh.h>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+
+typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+typedef CGAL::Surface_mesh<K::Point_3> Surface_mesh;
+
+namespace {
+
+// 硬件缓存未命中计数器；内核或容器不允许时 available() 为 false
+class Cache_miss_counter {
+public:
+    Cache_miss_counter() : fd_(-1) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~Cache_miss_counter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    bool available() const { return fd_ >= 0; }
+    void start() {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    long long stop() {
+        long long count = 0;
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+// 把原模型复制 copies 份并随机打乱顶点与三角形的编号
+void build_shuffled_soup(const Binary_STL_view& view, std::size_t copies, STL_soup& out) {
+    STL_soup base;
+    read_binary_STL(view, base);
+    float lo[3] = {1e30f, 1e30f, 1e30f};
+    float hi[3] = {-1e30f, -1e30f, -1e30f};
+    for (const auto& p : base.points) {
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = std::min(lo[i], p[i]);
+            hi[i] = std::max(hi[i], p[i]);
+        }
+    }
+    const float step[3] = {1.1f * (hi[0] - lo[0]) + 1.0f, 1.1f * (hi[1] - lo[1]) + 1.0f, 1.1f * (hi[2] - lo[2]) + 1.0f};
+    std::size_t side = 1;
+    while (side * side * side < copies) {
+        ++side;
+    }
+
+    const std::size_t nv = base.points.size() * copies;
+    std::vector<std::uint32_t> perm(nv);
+    std::iota(perm.begin(), perm.end(), 0u);
+    std::mt19937 rng(12345);
+    std::shuffle(perm.begin(), perm.end(), rng);
+
+    out.points.assign(nv, std::array<float, 3>());
+    out.triangles.clear();
+    out.triangles.reserve(base.triangles.size() * copies);
+    for (std::size_t c = 0; c < copies; ++c) {
+        const float offset[3] = {step[0] * (c % side), step[1] * ((c / side) % side), step[2] * (c / (side * side))};
+        const std::size_t first = c * base.points.size();
+        for (std::size_t i = 0; i < base.points.size(); ++i) {
+            std::array<float, 3> p = base.points[i];
+            for (int k = 0; k < 3; ++k) {
+                p[k] += offset[k];
+            }
+            out.points[perm[first + i]] = p;
+        }
+        for (const auto& t : base.triangles) {
+            out.triangles.push_back({{perm[first + t[0]], perm[first + t[1]], perm[first + t[2]]}});
+        }
+    }
+    std::shuffle(out.triangles.begin(), out.triangles.end(), rng);
+}
+
+// 一环邻域遍历：对每个顶点累加相邻顶点坐标，光顺、曲率估计等算子的典型访问模式
+double one_ring_pass(const Surface_mesh& mesh) {
+    double sum = 0;
+    for (auto v : mesh.vertices()) {
+        for (auto u : CGAL::vertices_around_target(mesh.halfedge(v), mesh)) {
+            sum += mesh.point(u).x();
+        }
+    }
+    return sum;
+}
+
+// 逐面遍历：计算每个面的面积
+double face_pass(const Surface_mesh& mesh) {
+    double sum = 0;
+    for (auto f : mesh.faces()) {
+        auto h = mesh.halfedge(f);
+        sum += std::sqrt(CGAL::to_double(CGAL::squared_area(mesh.point(mesh.source(h)), mesh.point(mesh.target(h)),
+                                                            mesh.point(mesh.target(mesh.next(h))))));
+    }
+    return sum;
+}
+
+template <typename Pass>
+void measure(const char* name, const Surface_mesh& mesh, Pass pass, Cache_miss_counter& counter) {
+    pass(mesh); // 预热
+    auto start = std::chrono::steady_clock::now();
+    counter.start();
+    volatile double sink = pass(mesh);
+    long long misses = counter.stop();
+    (void)sink;
+    std::cout << "  " << name << ": "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s, 缓存未命中 ";
+    if (counter.available()) {
+        std::cout << misses;
+    } else {
+        std::cout << "不可用";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string input = (argc > 1) ? argv[1] : "damaged_model.stl";
+    const std::size_t copies = (argc > 2) ? std::stoul(argv[2]) : 8000;
+
+    Surface_mesh mesh;
+    {
+        Mapped_file file(input);
+        Binary_STL_view view(file.data(), file.size());
+        if (!view.is_valid()) {
+            std::cerr << "输入必须是二进制 STL: " << input << std::endl;
+            return 1;
+        }
+        STL_soup soup;
+        build_shuffled_soup(view, copies, soup);
+        soup_to_mesh(soup, mesh);
+    }
+    std::cout << mesh.number_of_vertices() << " 顶点, " << mesh.number_of_faces() << " 面" << std::endl;
+
+    Cache_miss_counter counter;
+    if (!counter.available()) {
+        std::cout << "perf_event_open 不可用，只报告耗时" << std::endl;
+    }
+
+    std::cout << "打乱顺序:" << std::endl;
+    measure("一环遍历", mesh, one_ring_pass, counter);
+    measure("逐面遍历", mesh, face_pass, counter);
+
+    auto start = std::chrono::steady_clock::now();
+    const bool ok = reorder_mesh(mesh);
+    std::cout << "Morton 重排: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+              << " s, " << (ok ? "成功" : "失败") << std::endl;
+
+    std::cout << "重排之后:" << std::endl;
+    measure("一环遍历", mesh, one_ring_pass, counter);
+    measure("逐面遍历", mesh, face_pass, counter);
+    return ok ? 0 : 1;
+}
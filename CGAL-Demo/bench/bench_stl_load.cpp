@@ -0,0 +1,178 @@
+// 对比 STL 加载路径：ifstream + CGAL::IO::read_STL 与内存映射读取器；
+// 再对比写出路径：CGAL::IO::write_STL 与并行法向 + 内存映射写出器；
+// 最后对比 ASCII 读取：CGAL::IO::read_STL 与 SIMD 扫描 + from_chars 分块并行解析
+// 用法: bench_stl_load [输入 STL] [复制份数]
+// 输入模型会被平移复制若干份，拼成一个大的二进制 STL 后再计时
+#include "../STL_reader.h"
+#include "../Vertex_welder.h"
+#include "../STL_writer.h"
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Surface_mesh.h>
+#include <CGAL/IO/STL.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+typedef CGAL::Surface_mesh<K::Point_3> Surface_mesh;
+
+namespace {
+
+// 把原模型按网格排布复制 copies 份，写成二进制 STL
+bool write_scaled_copy(const Binary_STL_view& view, std::size_t copies, const std::string& out) {
+    const std::size_t nf = view.number_of_facets();
+    float lo[3] = {1e30f, 1e30f, 1e30f};
+    float hi[3] = {-1e30f, -1e30f, -1e30f};
+    for (std::size_t f = 0; f < nf; ++f) {
+        for (int j = 0; j < 3; ++j) {
+            float p[3];
+            view.vertex(f, j, p);
+            for (int i = 0; i < 3; ++i) {
+                lo[i] = std::min(lo[i], p[i]);
+                hi[i] = std::max(hi[i], p[i]);
+            }
+        }
+    }
+
+    std::ofstream os(out, std::ios::binary);
+    if (!os) {
+        return false;
+    }
+    char header[80] = "bench_stl_load synthetic copy";
+    os.write(header, sizeof(header));
+    const std::uint32_t total = static_cast<std::uint32_t>(nf * copies);
+    os.write(reinterpret_cast<const char*>(&total), sizeof(total));
+
+    // 每份之间留出 10% 间隙，避免副本之间顶点重合
+    const float step[3] = {1.1f * (hi[0] - lo[0]) + 1.0f, 1.1f * (hi[1] - lo[1]) + 1.0f, 1.1f * (hi[2] - lo[2]) + 1.0f};
+    std::size_t side = 1;
+    while (side * side * side < copies) {
+        ++side;
+    }
+    char record[Binary_STL_view::facet_size];
+    for (std::size_t c = 0; c < copies; ++c) {
+        const float offset[3] = {step[0] * (c % side), step[1] * ((c / side) % side), step[2] * (c / (side * side))};
+        for (std::size_t f = 0; f < nf; ++f) {
+            std::memcpy(record, view.facet(f), sizeof(record));
+            for (int j = 0; j < 3; ++j) {
+                float p[3];
+                view.vertex(f, j, p);
+                for (int i = 0; i < 3; ++i) {
+                    p[i] += offset[i];
+                }
+                std::memcpy(record + 12 + 12 * j, p, sizeof(p));
+            }
+            os.write(record, sizeof(record));
+        }
+    }
+    return static_cast<bool>(os);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string input = (argc > 1) ? argv[1] : "damaged_model.stl";
+    const std::size_t copies = (argc > 2) ? std::stoul(argv[2]) : 8000;
+    const std::string scaled = "bench_stl_load_scaled.stl";
+
+    {
+        Mapped_file file(input);
+        Binary_STL_view view(file.data(), file.size());
+        if (!view.is_valid()) {
+            std::cerr << "输入必须是二进制 STL: " << input << std::endl;
+            return 1;
+        }
+        if (!write_scaled_copy(view, copies, scaled)) {
+            std::cerr << "无法写出放大后的测试文件" << std::endl;
+            return 1;
+        }
+        std::cout << "测试文件: " << scaled << " (" << view.number_of_facets() * copies << " 个面片)" << std::endl;
+    }
+
+    // 现有路径：iostream 逐面片解析
+    {
+        auto start = std::chrono::steady_clock::now();
+        Surface_mesh mesh;
+        std::ifstream is(scaled, std::ios::binary);
+        bool ok = CGAL::IO::read_STL(is, mesh);
+        std::cout << "CGAL::IO::read_STL : " << seconds_since(start) << " s, "
+                  << (ok ? "成功" : "失败") << ", " << mesh.number_of_vertices() << " 顶点, "
+                  << mesh.number_of_faces() << " 面" << std::endl;
+    }
+
+    // 新路径：内存映射 + 原地遍历记录 + 预留容量建网格
+    {
+        auto start = std::chrono::steady_clock::now();
+        Surface_mesh mesh;
+        Mapped_file file(scaled);
+        Binary_STL_view view(file.data(), file.size());
+        STL_soup soup;
+        read_binary_STL(view, soup);
+        std::size_t rejected = soup_to_mesh(soup, mesh);
+        std::cout << "mmap 读取器        : " << seconds_since(start) << " s, " << mesh.number_of_vertices()
+                  << " 顶点, " << mesh.number_of_faces() << " 面, 丢弃 " << rejected << " 面" << std::endl;
+    }
+
+    // 内存映射 + 多线程分片哈希焊接
+    {
+        auto start = std::chrono::steady_clock::now();
+        Surface_mesh mesh;
+        Mapped_file file(scaled);
+        Binary_STL_view view(file.data(), file.size());
+        STL_soup soup;
+        weld_binary_STL(view, Weld_options(), soup);
+        std::size_t rejected = soup_to_mesh(soup, mesh);
+        std::cout << "mmap + 并行焊接    : " << seconds_since(start) << " s, " << mesh.number_of_vertices()
+                  << " 顶点, " << mesh.number_of_faces() << " 面, 丢弃 " << rejected << " 面" << std::endl;
+
+        const std::string written = "bench_stl_load_written.stl";
+        start = std::chrono::steady_clock::now();
+        bool ok = CGAL::IO::write_STL(written, mesh);
+        std::cout << "CGAL::IO::write_STL: " << seconds_since(start) << " s, " << (ok ? "成功" : "失败") << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        ok = write_binary_STL(written, mesh);
+        std::cout << "并行法向 + mmap 写出: " << seconds_since(start) << " s, " << (ok ? "成功" : "失败") << std::endl;
+        std::remove(written.c_str());
+
+        const std::string ascii = "bench_stl_load_ascii.stl";
+        if (!CGAL::IO::write_STL(ascii, mesh, CGAL::parameters::use_binary_mode(false))) {
+            std::cerr << "无法写出 ASCII 测试文件" << std::endl;
+            return 1;
+        }
+        {
+            start = std::chrono::steady_clock::now();
+            Surface_mesh ascii_mesh;
+            std::ifstream is(ascii);
+            ok = CGAL::IO::read_STL(is, ascii_mesh);
+            std::cout << "ASCII read_STL     : " << seconds_since(start) << " s, " << (ok ? "成功" : "失败") << ", "
+                      << ascii_mesh.number_of_vertices() << " 顶点" << std::endl;
+        }
+        {
+            start = std::chrono::steady_clock::now();
+            Surface_mesh ascii_mesh;
+            Mapped_file file(ascii);
+            std::vector<float> corners;
+            ok = parse_ascii_STL(file.data(), file.size(), corners);
+            STL_soup soup;
+            weld_STL_corners(corners, Weld_options(), soup);
+            soup_to_mesh(soup, ascii_mesh);
+            std::cout << "ASCII 并行解析     : " << seconds_since(start) << " s, " << (ok ? "成功" : "失败") << ", "
+                      << ascii_mesh.number_of_vertices() << " 顶点" << std::endl;
+        }
+        std::remove(ascii.c_str());
+    }
+
+    std::remove(scaled.c_str());
+    return 0;
+}
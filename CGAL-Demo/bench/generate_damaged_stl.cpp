@@ -0,0 +1,61 @@
+// 生成带缺陷的合成 STL，用于测量修复流程随规模的变化
+// 用法: generate_damaged_stl [选项] <输出 STL> <面片数>
+#include "../Damaged_mesh_generator.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void print_usage(const char* program) {
+    std::cerr << "用法: " << program << " [选项] <输出 STL> <面片数>" << std::endl;
+    std::cerr << "选项:" << std::endl;
+    std::cerr << "  --gaps <条数>            裂缝条数" << std::endl;
+    std::cerr << "  --gap-width <值>         裂缝宽度（默认 0.01）" << std::endl;
+    std::cerr << "  --duplicates <比例>      含近重复顶点的面片比例" << std::endl;
+    std::cerr << "  --non-manifold <个数>    非流形顶点个数" << std::endl;
+    std::cerr << "  --isolated <个数>        孤立顶点个数" << std::endl;
+    std::cerr << "  --flipped <比例>         法向翻转的面片比例" << std::endl;
+    std::cerr << "  --seed <值>              随机种子（默认 1）" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    Defect_options options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--gaps" && i + 1 < argc) {
+            options.gaps = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--gap-width" && i + 1 < argc) {
+            options.gap_width = std::atof(argv[++i]);
+        } else if (arg == "--duplicates" && i + 1 < argc) {
+            options.duplicate_ratio = std::atof(argv[++i]);
+        } else if (arg == "--non-manifold" && i + 1 < argc) {
+            options.non_manifold_vertices = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--isolated" && i + 1 < argc) {
+            options.isolated_vertices = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--flipped" && i + 1 < argc) {
+            options.flipped_ratio = std::atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg.compare(0, 2, "--") == 0) {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    options.facets = std::strtoull(positional[1].c_str(), nullptr, 10);
+
+    const std::size_t written = generate_damaged_STL(positional[0], options);
+    if (written == 0) {
+        std::cerr << "生成失败: " << positional[0] << std::endl;
+        return 1;
+    }
+    std::cout << "已写出 " << written << " 个面片到 " << positional[0] << std::endl;
+    return 0;
+}
@@ -1,32 +1,152 @@
 #include "LAR_STL.h"
+#include "Streaming_repair.h"
+#include "Batch_runner.h"
+#include "Batch_pipeline.h"
+#include "Repair_cache.h"
+#include "Repair_server.h"
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
-int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "用法: " << argv[0] << " <输入 STL 文件路径> <输出 STL 文件路径>" << std::endl;
-        return 1;
+static void print_usage(const char* program) {
+    std::cerr << "用法: " << program << " [选项] <输入 STL 文件路径> <输出 STL 文件路径>" << std::endl;
+    std::cerr << "      " << program << " --batch [选项] <输入目录或清单文件> <输出目录>" << std::endl;
+    std::cerr << "      " << program << " --serve <套接字路径> [选项]" << std::endl;
+    std::cerr << "      " << program << " --connect <套接字路径> <输入 STL 文件路径> <输出 STL 文件路径>" << std::endl;
+    std::cerr << "选项:" << std::endl;
+    std::cerr << "  --tolerance <值>  顶点焊接容差（默认 0，只合并完全相同的点）" << std::endl;
+    std::cerr << "  --stitch-tolerance <值>  按连通分量做容差缝合（高级修复），单位毫米" << std::endl;
+    std::cerr << "  --threads <数量>  并行线程数（默认使用全部硬件线程）" << std::endl;
+    std::cerr << "  --by-component    按连通分量并行修复（多壳体装配体），结果与线程数无关" << std::endl;
+    std::cerr << "  --keep-duplicates 不在建网格前删除重复与退化面片" << std::endl;
+    std::cerr << "  --keep-orientation 不在建网格前统一面片朝向" << std::endl;
+    std::cerr << "  --no-fill-holes   不填补缝合后剩余的洞" << std::endl;
+    std::cerr << "  --max-hole-edges <数量>  超过该边数的开口只报告不填补（默认 1000）" << std::endl;
+    std::cerr << "  --stream          流式分块修复，用于超出内存的大文件" << std::endl;
+    std::cerr << "  --memory-budget <MB>  流式修复单块内存预算（默认 1024）" << std::endl;
+    std::cerr << "  --batch           批处理：每个文件一条修复流程，在工作窃取线程池上并发执行" << std::endl;
+    std::cerr << "  --jobs <数量>     批处理并发文件数（默认使用全部硬件线程）" << std::endl;
+    std::cerr << "  --summary <路径>  批处理逐文件结果汇总（默认 <输出目录>/summary.csv）" << std::endl;
+    std::cerr << "  --pipeline        批处理改用读/修复/写三级流水线，io_uring 预读输入并异步写出" << std::endl;
+    std::cerr << "  --prefetch-budget <MB>  流水线中已读入与待写出缓冲的内存上限（默认 512）" << std::endl;
+    std::cerr << "  --no-io-uring     流水线不使用 io_uring，改用 pread/pwrite" << std::endl;
+    std::cerr << "  --float           单精度存储网格（内存减半，跳过自相交修复），仅单文件模式" << std::endl;
+    std::cerr << "  --report <路径>   单文件模式下写出各阶段耗时、CPU 时间、内存与元素数量的 JSON 报告" << std::endl;
+    std::cerr << "  --serve <路径>    常驻服务：在 Unix 域套接字上接收修复任务，--jobs 为工作线程数" << std::endl;
+    std::cerr << "  --connect <路径>  把修复任务交给已启动的常驻服务" << std::endl;
+    std::cerr << "  --cache           启用修复结果缓存（按输入内容与修复参数），仅单文件模式" << std::endl;
+    std::cerr << "  --cache-dir <路径>  缓存目录（默认 ~/.cache/lar_stl），指定即启用缓存" << std::endl;
+    std::cerr << "  --cache-size <MB>   缓存容量上限（默认 10240），超出后淘汰最久未用的条目" << std::endl;
+}
+
+// 机器可读的修复报告，供监控面板采集
+// 报告只描述修复结果，不含输入输出路径：缓存按内容复用报告，路径在写出时按本次运行填入
+template <typename Stl>
+static std::string make_report(const Stl& stl, const Manifold_report& manifold, const Mesh_quality& quality,
+                               bool saved) {
+    std::ostringstream os;
+    const typename Stl::Mesh& mesh = stl.get_repaired_mesh();
+    os << "{\n";
+    os << "  \"ok\": " << (saved ? "true" : "false") << ",\n";
+    os << "  \"vertices\": " << mesh.number_of_vertices() << ",\n";
+    os << "  \"faces\": " << mesh.number_of_faces() << ",\n";
+    os << "  \"rejected_facets\": " << stl.get_rejected_facets() << ",\n";
+    os << "  \"manifold\": " << (manifold.is_manifold() ? "true" : "false") << ",\n";
+    os << "  \"non_manifold_edges\": " << manifold.non_manifold_edges.size() << ",\n";
+    os << "  \"non_manifold_vertices\": " << manifold.non_manifold_vertices.size() << ",\n";
+    os << "  \"border_edges\": " << manifold.border_edges << ",\n";
+    os << "  \"total_wall_seconds\": " << stl.get_profile().total_wall_seconds() << ",\n";
+    os << "  \"peak_rss\": " << Stage_profiler::peak_rss() << ",\n";
+    os << "  \"quality_before\": ";
+    stl.get_input_quality().write_json(os);
+    os << ",\n  \"quality_after\": ";
+    quality.write_json(os);
+    os << ",\n";
+    os << "  \"stages\": ";
+    stl.get_profile().write_json(os);
+    os << "\n}\n";
+    return os.str();
+}
+
+// 报告写出时才加上缓存状态与本次运行的输入输出路径，缓存里保存的报告不含这些字段
+static bool write_report(const std::string& path, const std::string& report, const char* cache_state,
+                         const std::string& input, const std::string& output) {
+    std::ofstream os(path);
+    if (!os) {
+        std::cerr << "无法写出报告 " << path << std::endl;
+        return false;
     }
+    os << "{\n  \"cache\": \"" << cache_state << "\",\n";
+    os << "  \"input\": " << json_quote(input) << ",\n";
+    os << "  \"output\": " << json_quote(output) << ",";
+    os << report.substr(report.find('{') + 1);
+    return static_cast<bool>(os);
+}
 
-    std::string input_filename = argv[1];
-    std::string output_filename = argv[2];
+// 常驻服务按自己的工作目录解析路径，客户端发送前转成绝对路径
+static std::string absolute_path(const std::string& path) {
+    if (!path.empty() && path[0] == '/') {
+        return path;
+    }
+    char cwd[4096];
+    return ::getcwd(cwd, sizeof(cwd)) != nullptr ? std::string(cwd) + "/" + path : path;
+}
 
+// 影响修复结果的参数；线程数与输出开关不影响结果，不参与缓存键
+static std::string repair_settings(const Repair_options& options, bool single_precision) {
+    std::ostringstream os;
+    os.precision(17);
+    os << "weld=" << options.weld_tolerance << ";stitch=" << options.stitch_tolerance
+       << ";self_intersections=" << options.repair_self_intersections << ";reorder=" << options.reorder_for_locality
+       << ";float=" << single_precision << ";by_component=" << options.repair_by_component
+       << ";remove_duplicates=" << options.remove_duplicate_facets << ";orient=" << options.orient_facets
+       << ";fill_holes=" << options.fill_holes << ";max_hole_edges=" << options.max_hole_edges;
+    return os.str();
+}
+
+// 质量摘要，用于修复前后对比
+static void print_quality(const char* title, const Mesh_quality& q) {
+    std::cout << title << "：" << q.faces << " 个面（退化 " << q.degenerate_faces << "），最小角 " << q.min_angle
+              << "°，纵横比 最大 " << q.max_aspect_ratio << " / 平均 " << q.mean_aspect_ratio << "，总面积 "
+              << q.total_area << "，包围盒 [" << q.bbox_min[0] << ", " << q.bbox_min[1] << ", " << q.bbox_min[2]
+              << "] - [" << q.bbox_max[0] << ", " << q.bbox_max[1] << ", " << q.bbox_max[2] << "]，边界边 "
+              << q.border_edges << std::endl;
+}
+
+// 单文件修复：加载、修复、检查流形性并保存，返回是否成功保存并生成报告
+template <typename Stl>
+static bool repair_single(const std::string& input_filename, const std::string& output_filename,
+                          const Repair_options& options, std::string& report_json) {
     // 创建 LAR_STL 对象并加载和修复文件
-    LAR_STL stl_processor(input_filename);
+    Stl stl_processor(input_filename, options);
 
     // 检查文件是否成功加载和修复
+    bool saved = false;
+    Manifold_report report;
+    Mesh_quality quality;
     if (!stl_processor.get_repaired_mesh().is_empty()) {
         std::cout << "文件加载和修复成功。" << std::endl;
 
         // 验证流形性
-        if (stl_processor.is_manifold()) {
+        report = stl_processor.check_manifold();
+        if (report.is_manifold()) {
             std::cout << "修复后的网格是流形的。" << std::endl;
         } else {
-            std::cout << "修复后的网格不是流形的。" << std::endl;
+            std::cout << "修复后的网格不是流形的：" << report.non_manifold_edges.size() << " 条非流形边，"
+                      << report.non_manifold_vertices.size() << " 个非流形顶点。" << std::endl;
         }
+        std::cout << "边界边: " << report.border_edges << std::endl;
+        quality = stl_processor.measure_quality();
+        print_quality("修复前", stl_processor.get_input_quality());
+        print_quality("修复后", quality);
 
         // 保存修复后的网格
-        if (stl_processor.save_repaired_mesh(output_filename)) {
+        saved = stl_processor.save_repaired_mesh(output_filename);
+        if (saved) {
             std::cout << "修复后的网格已保存到 " << output_filename << std::endl;
         } else {
             std::cerr << "保存修复后的网格时出错。" << std::endl;
@@ -35,5 +155,154 @@ int main(int argc, char* argv[]) {
         std::cerr << "文件加载和修复失败。" << std::endl;
     }
 
+    report_json = make_report(stl_processor, report, quality, saved);
+    return saved;
+}
+
+int main(int argc, char* argv[]) {
+    Repair_options options;
+    Streaming_options streaming;
+    bool stream = false;
+    bool batch = false;
+    bool pipelined = false;
+    Batch_pipeline_options pipeline;
+    bool single_precision = false;
+    unsigned jobs = 0;
+    std::string summary;
+    std::string report_path;
+    bool use_cache = false;
+    std::string serve_socket;
+    std::string connect_socket;
+    std::string cache_dir;
+    std::uint64_t cache_size = std::uint64_t(10240) << 20;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tolerance" && i + 1 < argc) {
+            options.weld_tolerance = std::atof(argv[++i]);
+        } else if (arg == "--stitch-tolerance" && i + 1 < argc) {
+            options.stitch_tolerance = std::atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.num_threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--by-component") {
+            options.repair_by_component = true;
+        } else if (arg == "--keep-duplicates") {
+            options.remove_duplicate_facets = false;
+        } else if (arg == "--keep-orientation") {
+            options.orient_facets = false;
+        } else if (arg == "--no-fill-holes") {
+            options.fill_holes = false;
+        } else if (arg == "--max-hole-edges" && i + 1 < argc) {
+            options.max_hole_edges = static_cast<std::size_t>(std::atoll(argv[++i]));
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            streaming.memory_budget = static_cast<std::size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--pipeline") {
+            pipelined = true;
+        } else if (arg == "--prefetch-budget" && i + 1 < argc) {
+            pipeline.memory_budget = static_cast<std::size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        } else if (arg == "--no-io-uring") {
+            pipeline.use_io_uring = false;
+        } else if (arg == "--summary" && i + 1 < argc) {
+            summary = argv[++i];
+        } else if (arg == "--float") {
+            single_precision = true;
+        } else if (arg == "--report" && i + 1 < argc) {
+            report_path = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serve_socket = argv[++i];
+        } else if (arg == "--connect" && i + 1 < argc) {
+            connect_socket = argv[++i];
+        } else if (arg == "--cache") {
+            use_cache = true;
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            use_cache = true;
+            cache_dir = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            cache_size = static_cast<std::uint64_t>(std::atof(argv[++i]) * 1024 * 1024);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    // 常驻服务模式：不处理命令行给出的文件，直到收到 SIGINT / SIGTERM
+    if (!serve_socket.empty()) {
+        if (!positional.empty()) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return run_repair_server(serve_socket, options, jobs) ? 0 : 1;
+    }
+
+    if (positional.size() != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string input_filename = positional[0];
+    std::string output_filename = positional[1];
+
+    // 客户端模式：修复由常驻服务完成，本进程不加载网格
+    if (!connect_socket.empty()) {
+        std::string reply;
+        const bool ok = send_repair_request(connect_socket, absolute_path(input_filename),
+                                            absolute_path(output_filename), reply);
+        (ok ? std::cout : std::cerr) << reply << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    // 批处理模式：一个进程处理整个目录或清单
+    if (batch) {
+        std::vector<Batch_item> items;
+        if (!collect_batch_items(input_filename, output_filename, items)) {
+            return 1;
+        }
+        std::vector<Batch_result> results;
+        const std::string summary_path = summary.empty() ? output_filename + "/summary.csv" : summary;
+        const bool ok = pipelined ? run_batch_pipeline(items, options, jobs, pipeline, summary_path, results)
+                                  : run_batch(items, options, jobs, summary_path, results);
+        return ok ? 0 : 1;
+    }
+
+    // 流式模式：分块修复并增量写出，不在内存中保留整个网格
+    if (stream) {
+        return stream_repair_STL(input_filename, output_filename, options, streaming) ? 0 : 1;
+    }
+
+    // 修复结果缓存：相同内容与参数的输入直接复制缓存的网格和报告，不再建网格
+    Repair_cache cache(cache_dir.empty() ? Repair_cache::default_directory() : cache_dir, cache_size);
+    std::string cache_key;
+    if (use_cache) {
+        cache_key = cache.key(input_filename, repair_settings(options, single_precision), options.num_threads);
+        std::string cached_report;
+        if (cache.lookup(cache_key, output_filename, cached_report)) {
+            std::cout << "命中修复缓存，修复后的网格已保存到 " << output_filename << std::endl;
+            const bool ok = report_path.empty() ||
+                            write_report(report_path, cached_report, "hit", input_filename, output_filename);
+            return ok ? 0 : 1;
+        }
+    }
+
+    // 单文件模式下输出修复前后的质量对比；只做统计，不影响修复结果与缓存键
+    options.measure_input_quality = true;
+    std::string report_json;
+    const bool saved = single_precision
+                           ? repair_single<LAR_STL_float>(input_filename, output_filename, options, report_json)
+                           : repair_single<LAR_STL>(input_filename, output_filename, options, report_json);
+    if (saved && use_cache && !cache.store(cache_key, output_filename, report_json)) {
+        std::cerr << "警告：修复结果未能写入缓存" << std::endl;
+    }
+    if (!report_path.empty() && !write_report(report_path, report_json, use_cache ? "miss" : "off", input_filename,
+                                              output_filename)) {
+        return 1;
+    }
     return 0;
-}    
\ No newline at end of file
+}